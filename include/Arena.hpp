@@ -0,0 +1,50 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+class ArenaDeleter {
+  /* Destroys an entity allocated from a memory resource and hands its
+     storage back. Monotonic arenas ignore the hand-back and reclaim
+     everything at once on release.
+   */
+public:
+  ArenaDeleter(){};
+  ArenaDeleter(std::pmr::memory_resource *resource, std::size_t size,
+               std::size_t alignment)
+      : _resource(resource), _size(size), _alignment(alignment) {}
+
+  template <class T> void operator()(T *entity) const {
+    entity->~T();
+    if (_resource != nullptr) {
+      _resource->deallocate(entity, _size, _alignment);
+    }
+  }
+
+private:
+  std::pmr::memory_resource *_resource{nullptr};
+  std::size_t _size{0};
+  std::size_t _alignment{alignof(std::max_align_t)};
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+template <class T, class... Args>
+ArenaPtr<T> makeArena(std::pmr::memory_resource *resource, Args &&...args) {
+  /* Constructs an entity in the given memory resource.
+   */
+  void *storage = resource->allocate(sizeof(T), alignof(T));
+  try {
+    auto entity = new (storage) T(std::forward<Args>(args)...);
+    return ArenaPtr<T>(entity,
+                       ArenaDeleter(resource, sizeof(T), alignof(T)));
+  } catch (...) {
+    resource->deallocate(storage, sizeof(T), alignof(T));
+    throw;
+  }
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ARRIVALS_HPP
+#define ARRIVALS_HPP
+
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <string>
+
+struct Arrival {
+  time_t time; // Absolute arrival time
+  time_t work; // Execution demand
+};
+
+class ArrivalStream {
+  /* A source of aperiodic jobs in arrival order, pulled one at a
+     time so that long streams are never held in memory.
+   */
+public:
+  virtual ~ArrivalStream(){};
+  virtual bool next(Arrival &arrival) = 0;
+  virtual void rewind() = 0;
+};
+
+class PoissonArrivals : public ArrivalStream {
+  /* Generates jobs with exponential inter-arrival times and work,
+     given their means, rounded to whole time units (work of at
+     least 1). A negative count makes the stream endless.
+   */
+public:
+  PoissonArrivals(double interarrival, double work, long count = -1,
+                  unsigned seed = 1);
+  bool next(Arrival &arrival) override;
+  void rewind() override;
+
+private:
+  std::exponential_distribution<double> _interarrival;
+  std::exponential_distribution<double> _work;
+  long _count;
+  unsigned _seed;
+  std::mt19937_64 _rng;
+  double _t{0.0};
+  long _left;
+};
+
+class FileArrivals : public ArrivalStream {
+  /* Reads jobs from a file of "time, work" lines, in arrival order.
+   */
+public:
+  FileArrivals(const std::string &filename);
+  bool next(Arrival &arrival) override;
+  void rewind() override;
+
+private:
+  std::ifstream _file;
+};
+
+#endif
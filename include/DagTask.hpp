@@ -0,0 +1,59 @@
+#ifndef DAG_TASK_HPP
+#define DAG_TASK_HPP
+
+#include <Task.hpp>
+#include <vector>
+
+class DagTask : public Task {
+  /* A parallel task whose jobs are DAGs of nodes under precedence
+     constraints, sharing one period and deadline. Ready nodes of a
+     job may run on several processors at once.
+   */
+public:
+  struct Node {
+    time_t C;
+    std::vector<int> successors;
+  };
+
+  DagTask(time_t T, time_t D, std::vector<Node> nodes, time_t O = 0);
+
+  const std::vector<Node> &nodes() const { return _nodes; };
+  void reset(bool start = true) override;
+  void skip() override;
+  void allocateProcessor(ProcessorPtr processor) override;
+  ProcessorPtr releaseProcessor() override;
+  bool hasProcessor() override { return !_processors.empty(); };
+
+  static Parameters parameters(time_t T, time_t D,
+                               const std::vector<Node> &nodes, time_t O = 0);
+
+protected:
+  void execute(time_t dt) override;
+  time_t span() const override { return _span + debt(); };
+
+private:
+  DagTask(time_t T, time_t D, std::vector<time_t> tail,
+          std::vector<Node> nodes, time_t O);
+
+  std::vector<Node> _nodes;
+  std::vector<int> _predecessors; // In-degree of each node
+  std::vector<time_t> _tail;      // Longest path from each node to a sink
+
+  // Per-job state
+  std::vector<int> _indegree;     // Unfinished predecessors
+  std::vector<time_t> _remaining; // Pending work of each node
+  std::vector<double> _residues;  // Fractional work carried per node
+  std::vector<int> _frontier;     // Ready (or running) nodes, FIFO
+  time_t _span{0};                // Remaining critical path
+  std::vector<ProcessorPtr> _processors;
+
+  void resetNodes();
+  void updateSpan();
+
+  static std::vector<time_t> tails(const std::vector<Node> &nodes);
+  static Parameters parameters(time_t T, time_t D,
+                               const std::vector<Node> &nodes,
+                               const std::vector<time_t> &tail, time_t O);
+};
+
+#endif
@@ -15,6 +15,9 @@ public:
   void updateTrace(int index, int value);
   void updateList(ListingType type, int index, int value, std::string state);
   void clearLists();
+  void drawReplay(time_t from, time_t zoom,
+                  const std::vector<std::vector<int>> &view);
+  int traceColumns() const { return _traceWidth - 2; };
   ~Display();
 
 private:
@@ -31,6 +34,7 @@ private:
   WINDOW *drawListing(int height, int width, int starty, int startx,
                       std::string title, std::string heading);
   void drawTime();
+  void drawTime(time_t from, time_t zoom);
   void drawTraces();
   void drawListings();
 };
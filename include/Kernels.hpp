@@ -0,0 +1,100 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace Kernels {
+enum class Level { SCALAR, SSE42, AVX2 };
+
+using Mask = std::vector<uint64_t>;
+
+template <typename Time> struct Lanes {
+  /* Time attributes of packed tasks, laid out as contiguous arrays.
+   */
+  std::vector<Time> Ct;
+  std::vector<Time> Dt;
+  std::vector<Time> D;
+  std::vector<Time> t;
+  std::vector<Time> next; // Absolute time of the next release
+  std::vector<Time> Lt;
+  std::vector<Time> Rt;
+
+  void resize(std::size_t n) {
+    for (auto v : {&Ct, &Dt, &D, &t, &next, &Lt, &Rt}) {
+      v->resize(n);
+    }
+  }
+};
+
+struct Slot {
+  time_t t;
+  time_t Dt;
+  time_t Lt;
+  time_t Rt;
+};
+
+// Largest count of quanta held in 32 bits, with headroom for the sums
+// and differences taken while stepping
+constexpr int32_t maxQuanta = INT32_MAX / 4;
+
+inline bool fits(time_t quanta) {
+  return quanta >= -maxQuanta && quanta <= maxQuanta;
+}
+
+struct Batch {
+  /* Time attributes of tasks stepped without a processor, one slot
+     per task, kept between steps. Compact batches hold them as 32-bit
+     counts of quanta from `base`, which halves their footprint and
+     doubles the lanes per vector; packing a time that is not a whole
+     number of quanta, or too far out, widens the batch back to 64 bits.
+   */
+  Lanes<time_t> times;
+  Lanes<int32_t> quanta;
+  time_t quantum{0}; // Unit of the compact lanes, 0 when wide
+  time_t base{0};    // Origin of t and next in the compact lanes
+
+  std::size_t size() const { return _size; }
+  bool compact() const { return quantum > 0; }
+  void resize(std::size_t n);
+  void setScale(time_t quantum, time_t base);
+  void pack(std::size_t i, time_t Ct, time_t Dt, time_t D, time_t t,
+            time_t next);
+  Slot slot(std::size_t i) const;
+  void move(std::size_t from, std::size_t to);
+  void widen();
+
+private:
+  std::size_t _size{0};
+
+  bool narrow(std::size_t i, time_t Ct, time_t Dt, time_t D, time_t t,
+              time_t next);
+};
+
+inline bool test(const Mask &mask, std::size_t i) {
+  return (mask[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void clear(Mask &mask, std::size_t i) {
+  mask[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+inline bool any(const Mask &mask) {
+  for (auto word : mask) {
+    if (word != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Level detect();
+Level level();
+void setLevel(Level level);
+
+void advance(Batch &batch, time_t dt, Mask &misses, Mask &releases);
+}; // namespace Kernels
+
+#endif
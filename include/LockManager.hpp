@@ -0,0 +1,62 @@
+#ifndef LOCK_MANAGER_HPP
+#define LOCK_MANAGER_HPP
+
+#include <SharedResource.hpp>
+#include <Task.hpp>
+#include <set>
+#include <utility>
+#include <vector>
+
+class LockManager {
+  /* Arbitrates critical sections on shared resources under a
+     multiprocessor locking protocol:
+     - FMLP+: FIFO queues, waiting jobs suspend, holders are boosted.
+     - MrsP: FIFO queues, waiting jobs spin, holders run at ceiling
+       (boosted). Helping between processors is not modeled.
+     - PCP: priority-ordered waiting under the ceiling rule, waiting
+       jobs suspend, holders inherit from the higher priority jobs
+       they block, directly or through their ceiling.
+     - SRP: jobs start only above the system ceiling; requests that
+       find the resource taken on another processor spin in FIFO
+       order (as in MSRP).
+     Ceilings and priorities are relative deadlines (smaller is higher).
+     Both ceiling protocols are the global variants: no scheduler binds
+     tasks to processors, so the partitioned ones are not modeled.
+   */
+public:
+  enum class Protocol { FMLP_PLUS, MRSP, PCP, SRP };
+  enum class Outcome { GRANTED, SPIN, SUSPEND };
+
+  LockManager(Protocol protocol = Protocol::FMLP_PLUS)
+      : _protocol(protocol){};
+
+  Protocol protocol() const { return _protocol; };
+  void setProtocol(Protocol protocol) { _protocol = protocol; };
+  const std::vector<SharedResource> &resources() const { return _resources; };
+  bool empty() const { return _resources.empty(); };
+  time_t startBlocked() const { return _startBlocked; };
+
+  int addResource();
+  void use(int resource, time_t D);
+  bool admit(Task *task, time_t t);
+  Outcome request(Task *task, time_t t);
+  bool release(Task *task, time_t t);
+  void spun(const Task &task, time_t dt);
+  bool boosted(const Task &task) const;
+  void reset();
+
+private:
+  Protocol _protocol;
+  std::vector<SharedResource> _resources;
+  std::multiset<std::pair<time_t, int>> _ceilings; // Of locked resources
+  std::vector<SharedResource::Waiter> _pending; // Suspended under ceilings
+  time_t _startBlocked{0}; // Total time jobs were held back by SRP
+
+  SharedResource &resource(int id) { return _resources[id - 1]; };
+  bool passes(const Task &task) const;
+  void hold(Task *task, time_t t);
+  void grant(SharedResource &resource, Task *task, time_t t, time_t since);
+  bool wake(time_t t);
+};
+
+#endif
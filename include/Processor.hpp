@@ -3,14 +3,37 @@
 
 #include <Resource.hpp>
 #include <memory>
+#include <vector>
+
+struct OperatingPoint {
+  double frequency{1.0}; // Fraction of the nominal frequency
+  double voltage{1.0};
+};
+
+struct PowerModel {
+  double Ceff{1.0};    // Effective switched capacitance
+  double Pstatic{0.0}; // Leakage power, drawn busy or idle
+};
 
 class Processor : public Resource {
 public:
-  Processor() : Resource(++_idCount){};
+  Processor(double speed = 1.0) : Resource(++_idCount), _speed(speed){};
+  double speed() const { return _speed * frequency(); };
+  double frequency() const { return _points[_level].frequency; };
+  int level() const { return _level; };
+  const std::vector<OperatingPoint> &points() const { return _points; };
+  void setOperatingPoints(std::vector<OperatingPoint> points,
+                          PowerModel model = PowerModel());
+  void setLevel(int level);
+  void setFrequency(double frequency);
+  double power(bool busy) const;
   static void resetIdCount() { _idCount = 0; }
 
 private:
-  int _capacity{1};
+  double _speed{1.0}; // Work completed per unit of time at nominal frequency
+  std::vector<OperatingPoint> _points{OperatingPoint()};
+  int _level{0};
+  PowerModel _model;
   static int _idCount; // Global variable for counting processor object ids
 };
 
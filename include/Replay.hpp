@@ -0,0 +1,89 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct RecordHeader {
+  /* Start of a recorded run. Every step follows as a fixed-size
+     record: its start time and length, then the id of the task on
+     each processor (0 when idle).
+   */
+  char magic[4]{'R', 'T', 'S', 'R'};
+  int32_t version{1};
+  int32_t m{0};
+  int32_t reserved{0};
+};
+
+class Recorder {
+  /* Writes the schedule of a run, step by step.
+   */
+public:
+  Recorder(const std::string &filename, int m);
+  void write(time_t t, time_t dt, const std::vector<int> &ids);
+
+private:
+  std::ofstream _file;
+  std::vector<char> _record;
+};
+
+class Replay {
+  /* Reads a recorded run back. Records have a fixed size, so any
+     step is one seek away; a sparse index of checkpoints (the start
+     time of every few thousand steps) maps times to steps. A pyramid
+     of summaries, built in the same pass, keeps the longest holder of
+     each processor over blocks of steps, growing by a fixed factor
+     per level, so zoomed out views read blocks rather than steps.
+   */
+public:
+  struct Step {
+    time_t t;
+    time_t dt;
+    std::vector<int> ids;
+  };
+
+  Replay(const std::string &filename);
+
+  bool valid() const { return _steps > 0; };
+  int M() const { return _m; };
+  long steps() const { return _steps; };
+  time_t begin() const { return _begin; };
+  time_t end() const { return _end; };
+  long seek(time_t t);
+  bool read(long index, Step &step);
+  std::vector<std::vector<int>> window(time_t from, int columns,
+                                       time_t zoom);
+
+private:
+  struct Level {
+    long span;                // Steps per block
+    std::vector<time_t> from; // Start time of each block
+    std::vector<time_t> to;   // End time of each block
+    std::vector<int> ids;     // Longest holder of each processor, by block
+    std::vector<time_t> held; // How long it held the processor
+  };
+
+  static constexpr long _stride = 4096; // Steps between checkpoints
+  static constexpr long _block = 64;    // Steps per first level block
+  static constexpr long _fanout = 8;    // Blocks per next level block
+
+  std::ifstream _file;
+  int _m{0};
+  long _steps{0};
+  std::size_t _recordSize{0};
+  time_t _begin{0};
+  time_t _end{0};
+  std::vector<time_t> _checkpoints; // Start time of every stride-th step
+  long _cursor{-1};                 // Step the file is positioned at
+  std::vector<char> _record;
+  std::vector<Level> _levels; // Summaries, finest first, whole blocks only
+
+  void decode(const char *record, Step &step) const;
+  void summarize();
+  int widest(long index, time_t from, time_t zoom, time_t until) const;
+};
+
+#endif
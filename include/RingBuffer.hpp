@@ -0,0 +1,61 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+template <class T> class RingBuffer {
+  /* A FIFO queue over a circular buffer. The capacity is a power of
+     two and doubles when full, so steady streams never reallocate.
+   */
+public:
+  RingBuffer(std::size_t capacity = 16) {
+    std::size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    _items.resize(size);
+  }
+
+  bool empty() const { return _size == 0; };
+  std::size_t size() const { return _size; };
+  std::size_t capacity() const { return _items.size(); };
+  T &front() { return _items[_head]; };
+  const T &front() const { return _items[_head]; };
+
+  void push(T item) {
+    if (_size == _items.size()) {
+      grow();
+    }
+    _items[(_head + _size) & (_items.size() - 1)] = std::move(item);
+    _size += 1;
+  }
+
+  void pop() {
+    assert(_size > 0);
+    _head = (_head + 1) & (_items.size() - 1);
+    _size -= 1;
+  }
+
+  void clear() {
+    _head = 0;
+    _size = 0;
+  }
+
+private:
+  std::vector<T> _items;
+  std::size_t _head{0};
+  std::size_t _size{0};
+
+  void grow() {
+    std::vector<T> items(_items.size() * 2);
+    for (std::size_t i = 0; i < _size; i++) {
+      items[i] = std::move(_items[(_head + i) & (_items.size() - 1)]);
+    }
+    _items = std::move(items);
+    _head = 0;
+  }
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef SERVER_TASK_HPP
+#define SERVER_TASK_HPP
+
+#include <Arrivals.hpp>
+#include <RingBuffer.hpp>
+#include <Task.hpp>
+#include <memory>
+#include <vector>
+
+class ServerTask : public Task {
+  /* A bandwidth-reservation server: a budget Q (C) per period T that
+     serves a stream of aperiodic jobs in FIFO order, scheduled by
+     EDF or FP like any task.
+     - CBS: on exhausting its budget, the server recharges it at once
+       and postpones its deadline by T. An arrival at an idle server
+       keeps the current deadline only if the leftover budget fits
+       the bandwidth Q/T. Isolation relies on EDF.
+     - SPORADIC: the budget consumed during an active period is
+       returned one period after that period began.
+     - DEFERRABLE: the budget is refilled to Q at every period and
+       kept while there is nothing to serve.
+     Sporadic and deferrable servers lose budget they cannot use
+     before their deadline (the next replenishment) rather than
+     missing it. A retiring server serves out its current period
+     without recharging or reactivating, then leaves at its
+     deadline, dropping the jobs still queued.
+   */
+public:
+  enum class Kind { CBS, SPORADIC, DEFERRABLE };
+
+  struct Job {
+    time_t arrival;
+    time_t remaining;
+  };
+
+  struct ResponseTimes {
+    /* Histogram of response times; the last bucket collects
+       everything beyond the others.
+     */
+    time_t width{1};
+    std::vector<long> buckets;
+    long count{0};
+    double sum{0.0};
+    time_t max{0};
+
+    void add(time_t response);
+    double mean() const { return count > 0 ? sum / count : 0.0; };
+    time_t percentile(double p) const;
+  };
+
+  ServerTask(Kind kind, time_t Q, time_t T,
+             std::unique_ptr<ArrivalStream> arrivals, time_t O = 0);
+
+  Kind kind() const { return _kind; };
+  time_t budget() const { return _budget; };
+  time_t backlog() const { return _backlog; };
+  std::size_t pending() const { return _queue.size(); };
+  const ResponseTimes &responses() const { return _responses; };
+  void setHistogram(time_t width, std::size_t buckets);
+  void reset(bool start = true) override;
+  void pack(Kernels::Batch &batch, std::size_t i) const override;
+  void unpack(const Kernels::Batch &batch, std::size_t i,
+              bool released) override;
+
+protected:
+  void execute(time_t dt) override;
+  void advance(time_t dt) override;
+  time_t span() const override;
+
+private:
+  struct Replenishment {
+    time_t time;
+    time_t amount;
+  };
+
+  Kind _kind;
+  std::unique_ptr<ArrivalStream> _arrivals;
+  Arrival _next;       // Next arrival, pulled ahead of time
+  bool _more{false};   // The stream has not run out
+  RingBuffer<Job> _queue;
+  time_t _backlog{0};  // Remaining work of the queued jobs
+  time_t _budget{0};
+  time_t _deadline{0}; // Absolute deadline of the server
+  bool _active{false}; // Has both pending work and budget
+  time_t _activation{0};
+  time_t _consumed{0}; // Budget used since the activation (sporadic)
+  RingBuffer<Replenishment> _replenishments;
+  ResponseTimes _responses;
+
+  void refill();
+};
+
+#endif
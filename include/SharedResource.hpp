@@ -0,0 +1,44 @@
+#ifndef SHARED_RESOURCE_HPP
+#define SHARED_RESOURCE_HPP
+
+#include <Resource.hpp>
+#include <ctime>
+#include <deque>
+#include <limits>
+
+class Task;
+
+class SharedResource : public Resource {
+  /* A logical resource accessed by tasks within critical sections.
+   */
+public:
+  struct Waiter {
+    Task *task;
+    time_t since; // Time of the blocked request
+  };
+
+  struct Stats {
+    long acquisitions{0};
+    long contended{0};    // Acquisitions that had to wait
+    time_t blocked{0};    // Total time requests waited
+    time_t maxBlocked{0}; // Longest single wait
+    time_t spin{0};       // Processor time burnt spinning
+  };
+
+  SharedResource(int id) : Resource(id){};
+
+  bool locked() const { return _owner != nullptr; };
+  Task *owner() const { return _owner; };
+  time_t ceiling() const { return _ceiling; };
+  const Stats &stats() const { return _stats; };
+
+private:
+  friend class LockManager;
+
+  Task *_owner{nullptr};
+  std::deque<Waiter> _waiters; // FIFO of blocked requests
+  time_t _ceiling{std::numeric_limits<time_t>::max()}; // Smallest user D
+  Stats _stats;
+};
+
+#endif
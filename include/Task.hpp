@@ -1,10 +1,12 @@
 #ifndef TASK_HPP
 #define TASK_HPP
 
+#include <Kernels.hpp>
 #include <Processor.hpp>
 #include <Resource.hpp>
 #include <ctime>
 #include <memory>
+#include <vector>
 
 using ProcessorPtr = std::unique_ptr<Processor>;
 
@@ -15,7 +17,8 @@ public:
   struct Parameters {
     Parameters(){};
     Parameters(time_t C, time_t T, time_t D = 0, time_t O = 0)
-        : C(C), T(T), D(D), O(O), U{static_cast<double>(C) / T} {
+        : C(C), T(T), D(D), O(O), U{static_cast<double>(C) / T}, CH(C),
+          A(C), CP(C) {
       if (D == 0) {
         this->D = T;
       }
@@ -25,6 +28,10 @@ public:
     time_t D;
     time_t O{0};
     double U{0.0};
+    int L{0};  // Criticality level, 0 (LO) or 1 (HI)
+    time_t CH; // HI-criticality WCET, C is the LO one
+    time_t A;  // Actual execution time of each job, up to CH
+    time_t CP; // Critical path length, C for sequential tasks
   };
 
   struct Attributes {
@@ -36,6 +43,34 @@ public:
     time_t Lt;
     time_t Rt;
     time_t releases{1};
+    int Nt{1}; // Parts of the job ready to run in parallel
+  };
+
+  struct CriticalSection {
+    int resource;
+    time_t start; // Executed time of the job at which the section begins
+    time_t length;
+  };
+
+  struct Overheads {
+    time_t contextSwitch{0};    // Switching a job in
+    time_t preemption{0};       // Cache reload resuming on the same processor
+    time_t migration{0};        // Cache reload resuming on another processor
+    time_t scheduler{0};        // Scheduler invocation
+    time_t schedulerPerTask{0}; // Scheduler cost per ready task
+    time_t release{0};          // Job release
+    time_t tick{0};             // Timer tick, every quantum on a processor
+  };
+
+  struct OverheadStats {
+    long switches{0};
+    long preemptions{0};
+    long migrations{0};
+    time_t contextSwitch{0}; // Including scheduler invocations
+    time_t cpmd{0};          // Cache-related preemption/migration delay
+    time_t release{0};
+    time_t tick{0};
+    time_t total() const { return contextSwitch + cpmd + release + tick; };
   };
 
   Task(Parameters params);
@@ -43,7 +78,7 @@ public:
   Task &operator=(const Task &source) = delete;
   Task(Task &&source);
   Task &operator=(Task &&source);
-  ~Task(){};
+  virtual ~Task(){};
 
   double util() const { return _params.U; };
   const Parameters &params() const { return _params; };
@@ -51,29 +86,88 @@ public:
   const Status status() const { return _status; };
   std::string toString() const;
 
-  void reset(bool start = true);
+  virtual void reset(bool start = true);
   bool ready();
-  void allocateProcessor(ProcessorPtr processor) {
+  double speedOn(const Processor &processor) const;
+  void setSpeeds(std::vector<double> speeds) { _speeds = std::move(speeds); };
+  const std::vector<CriticalSection> &sections() const { return _sections; };
+  void setSections(std::vector<CriticalSection> sections);
+  const CriticalSection *pendingSection() const;
+  time_t executed() const { return _demand - (_attrs.Ct - _debt); };
+  time_t debt() const { return _debt; };
+  bool overran() const { return _overran; };
+  virtual void skip();
+  void retire() { _retiring = true; };
+  bool retiring() const { return _retiring; };
+  bool retired() const { return _retired; };
+  int held() const { return _held; };
+  bool spinning() const { return _spinning; };
+  bool suspended() const { return _suspended; };
+  void lock(int resource);
+  void unlock();
+  void spin() { _spinning = true; };
+  void suspend() { _suspended = true; };
+  void resume() { _suspended = false; };
+  const OverheadStats &overheads() const { return _overheads; };
+  bool switchIn(const Processor &processor, const Overheads &overheads,
+                time_t scheduling);
+  void chargeRelease(const Overheads &overheads);
+  virtual void allocateProcessor(ProcessorPtr processor) {
     _processor = std::move(processor);
   };
-  ProcessorPtr releaseProcessor() { return std::move(_processor); };
+  virtual ProcessorPtr releaseProcessor() { return std::move(_processor); };
   virtual bool stepped(const time_t t) { return _t == t; };
   virtual void dispatch(time_t dt = 1);
   virtual bool hasProcessor() { return _processor != nullptr; };
+  int slot() const { return _slot; };
+  void setSlot(int slot) { _slot = slot; };
+  bool polled() const { return _polled; };
+  virtual void pack(Kernels::Batch &batch, std::size_t i) const;
+  void restore(const Kernels::Batch &batch, std::size_t i);
+  virtual void unpack(const Kernels::Batch &batch, std::size_t i,
+                      bool released);
 
   static void resetIdCount() { _idCount = 0; }
 
 protected:
   time_t _t{0};
   ProcessorPtr _processor;
-
-private:
   Parameters _params;
   Attributes _attrs;
   Status _status{Status::IDLE};
+  bool _polled{false}; // Refreshed every step instead of from a batch
 
-  void invalidate();
+  Task(Parameters params, bool parallel);
+  virtual void execute(time_t dt);
+  virtual void advance(time_t dt);
+  virtual time_t span() const { return _attrs.Ct; };
   void update(bool reload = true);
+  time_t pay(time_t work);
+  bool expire();
+
+private:
+  std::vector<double> _speeds; // Per-processor speeds on unrelated platforms
+  double _residue{0.0};        // Fractional work carried between quanta
+  std::vector<CriticalSection> _sections; // Ordered by start, not nested
+  int _section{0}; // Next section of the current job
+  int _held{-1};   // Resource held by the current job
+  bool _spinning{false};
+  bool _suspended{false};
+  time_t _demand{0};     // Execution the current job is known to need
+  bool _overran{false}; // The current job exceeded its LO budget
+  time_t _debt{0};       // Charged overhead not yet executed, part of Ct
+  OverheadStats _overheads;
+  std::vector<int> _ranOn;      // Processors of the last step run
+  std::vector<int> _switchedOn; // Processors of the current step
+  time_t _ranUntil{-1};
+  bool _retiring{false}; // Leaves at the end of the current job's period
+  bool _retired{false};
+  int _slot{-1}; // Entry in the task system's batch, while active
+
+  void nextJob();
+
+  void invalidate();
+  void charge(time_t cost);
 
   static int _idCount; // Global variable for counting task object ids
 };
@@ -1,21 +1,39 @@
 #ifndef TASK_SYSTEM_HPP
 #define TASK_SYSTEM_HPP
 
+#include <Arena.hpp>
+#include <DagTask.hpp>
 #include <Display.hpp>
+#include <Kernels.hpp>
+#include <LockManager.hpp>
 #include <Processor.hpp>
+#include <Replay.hpp>
+#include <ServerTask.hpp>
 #include <Task.hpp>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <set>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 using TaskState =
     std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>;
-using TaskPtr = std::unique_ptr<Task>;
+using TaskPtr = ArenaPtr<Task>;
 using TaskSubSet = std::vector<TaskPtr>;
+using Arrivals = std::multimap<time_t, TaskPtr>;
 
 class TaskSystem {
 public:
-  TaskSystem(int m = 1, bool log = false);
+  enum class Admission { UTILIZATION, DENSITY };
+
+  TaskSystem(int m = 1, bool log = false,
+             std::pmr::memory_resource *upstream =
+                 std::pmr::get_default_resource());
+  TaskSystem(std::vector<double> speeds, bool log = false,
+             std::pmr::memory_resource *upstream =
+                 std::pmr::get_default_resource());
   TaskSystem(const TaskSystem &source) = delete;
   TaskSystem &operator=(const TaskSystem &source) = delete;
   TaskSystem(TaskSystem &&source);
@@ -25,39 +43,166 @@ public:
   const int M() const { return _m; }
   const int N() const { return _n; }
   double util() const { return _util; };
+  double capacity() const { return _capacity; };
   const time_t T() const { return _t; }
   const time_t dt() const { return _quantumSize; };
   const time_t H() const { return _hyperperiod; };
+  double energy() const { return _energy; };
+  double peakPower() const { return _peakPower; };
+  const LockManager &locks() const { return _locks; };
+  int mode() const { return _mode; };
+  long modeSwitches() const { return _modeSwitches; };
+  long lostJobs() const { return _lostJobs; };
+  time_t lostWork() const { return _lostWork; };
+  const Task::Overheads &overheads() const { return _overheads; };
+  std::map<int, Task::OverheadStats> overheadStats() const;
 
-  void addTask(Task::Parameters params);
+  int addTask(Task::Parameters params,
+              std::vector<Task::CriticalSection> sections = {},
+              std::vector<double> speeds = {});
+  int addDagTask(time_t T, time_t D, std::vector<DagTask::Node> nodes);
+  int addServer(ServerTask::Kind kind, time_t Q, time_t T,
+                std::unique_ptr<ArrivalStream> arrivals);
+  int admitTask(Task::Parameters params,
+                std::vector<Task::CriticalSection> sections = {},
+                std::vector<double> speeds = {});
+  bool admissible(const Task::Parameters &params) const;
+  bool retireTask(int id);
+  Task *task(int id) const;
+  ServerTask *server(int id) const {
+    return dynamic_cast<ServerTask *>(task(id));
+  };
+  void setAdmission(Admission test) { _admission = test; };
+  double density() const { return _density; };
+  int addResource() { return _locks.addResource(); };
+  void setProtocol(LockManager::Protocol protocol) {
+    _locks.setProtocol(protocol);
+  };
   void loadTasks(std::string filename);
+  void setOverheads(Task::Overheads overheads) { _overheads = overheads; };
+  void record(std::string filename) {
+    _recorder = std::make_shared<Recorder>(filename, _m);
+  };
+  void setDegradation(int every) { _degradation = every; };
+  void setCompact(bool enabled) {
+    _compactTime = enabled;
+    normalize();
+  };
+  bool compact() const { return _compact; };
+  void setOperatingPoints(std::vector<OperatingPoint> points,
+                          PowerModel model = PowerModel());
+  void setFrequency(double frequency);
+  void setFrequency(int index, double frequency);
   void reset();
-  TaskState readyState() { return getState(_readyTasks); };
-  TaskState completedState() { return getState(_completedTasks); };
-  time_t nextEventAt() const;
-  TaskState operator()(const std::vector<int> &indices, time_t proportion = 1);
+  void clear();
+  // Both refer to buffers owned by the system, valid until the next
+  // step, reset or clear; copy the state to keep it longer
+  const TaskState &readyState() {
+    return getState(_readyTasks, _readyState, &_holders);
+  };
+  const TaskState &completedState() {
+    return getState(_completedTasks, _completedState);
+  };
+  time_t nextEventAt() const; // time_t max when no event is pending
+  const TaskState &operator()(const std::vector<int> &indices,
+                              time_t proportion = 1);
   std::string toString() const;
 
 private:
   int _m{1};
   int _n{0};
   double _util{0.0};
+  double _capacity{1.0}; // Total speed of the platform
+  double _lambda{0.0};   // Uniform GFB factor, m - 1 when identical
+  bool _identical{true};
+
+  double _density{0.0};   // Sum of C / min(D, T)
+  std::multiset<double> _densities;
+  std::multiset<double> _utils;
+  std::multiset<time_t> _windows; // max(D, T), for the compact batch
+  std::map<time_t, int> _granules; // Times the quantum must divide, counted
+  std::map<time_t, int> _periods;  // Counted, for the hyperperiod
+  Admission _admission{Admission::UTILIZATION};
+
+  // Backs all tasks; declared ahead of the subsets so it outlives them.
+  // The pool recycles the storage of retired tasks
+  std::pmr::memory_resource *_upstream;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> _arena;
+  std::unique_ptr<std::pmr::unsynchronized_pool_resource> _pool;
 
   std::vector<ProcessorPtr> _processors;
   TaskSubSet _readyTasks;
   TaskSubSet _dispatchedTasks;
   TaskSubSet _completedTasks;
+  TaskSubSet _blockedTasks; // Suspended on shared resources
+  Arrivals _arrivals;       // Yet to join, by offset
+  std::unordered_map<int, Arrivals::iterator> _arriving; // By id
+  std::unordered_map<int, Task *> _index; // Tasks by id
+  TaskState _readyState;
+  TaskState _completedState;
+  TaskSubSet _nextReady; // Scratch for sorting the tasks after a step
+  TaskSubSet _nextCompleted;
+  TaskSubSet _nextBlocked;
+  Kernels::Batch _batch;       // Times of active tasks, between steps too
+  std::vector<Task *> _slots;  // Active tasks by batch slot
+  std::vector<Task *> _polled; // Active tasks refreshed every step
+  bool _moved{false};          // An idle task changed subset in the step
+  Kernels::Mask _misses;
+  Kernels::Mask _releases;
+  LockManager _locks;
+  std::vector<int> _holders;  // Ready indices of lock holders
+  std::vector<int> _selected; // Indices actually dispatched this step
+  Task::Overheads _overheads;
 
   time_t _t{0};
   time_t _quantumSize{0};
   time_t _hyperperiod{1};
+  double _power{0.0}; // Platform power over the current step
+  double _energy{0.0};
+  double _peakPower{0.0};
   std::shared_ptr<Display> _display;
+  std::shared_ptr<Recorder> _recorder;
+  std::vector<int> _running; // Task ids by processor, for the recorder
+
+  // Mixed-criticality mode and LO-task service loss
+  int _mode{0};
+  bool _switching{false};
+  int _degradation{0}; // Keep one LO job in every n in HI mode, 0 drops all
+
+  // Idle tasks step in 32-bit quanta while the task set allows it
+  bool _compactTime{true};
+  bool _compact{false};
+  bool _widened{false}; // The batch fell back to 64 bits, until a reset
+  long _modeSwitches{0};
+  long _lostJobs{0};
+  time_t _lostWork{0};
 
   void invalidate();
-  TaskState getState(const TaskSubSet &tasks);
+  int join(TaskPtr task);
+  void leave(Task &task);
+  void normalize();
+  void reserve(double U) const;
+  std::vector<time_t> granules(const Task &task) const;
+  void defer(TaskPtr task);
+  void enter(TaskPtr task);
+  void arrive();
+  void attach(Task &task);
+  void detach(Task &task);
+  void store(Task &task) { task.pack(_batch, task.slot()); };
+  void sync(Task &task) const;
+  const TaskState &getState(const TaskSubSet &tasks, TaskState &state,
+                            std::vector<int> *holders = nullptr);
+  const std::vector<int> &acquireLocks(const std::vector<int> &indices);
+  void releaseLocks(Task *task, time_t dt);
+  void released(Task &task);
+  void dropJob(Task &task);
   void dispatchTasks(const std::vector<int> &indices, time_t dt = 1);
-  void dispatchTasks(TaskSubSet &tasks, time_t dt = 1);
+  void idleTasks(time_t dt = 1);
+  void reclassify(bool switching);
+  void route(TaskPtr &task, bool switching);
   void acquireResources(TaskPtr &task);
+  ProcessorPtr &fastestProcessor(const Task &task);
+  Processor &processor(int index);
 };
 
 #endif
@@ -0,0 +1,31 @@
+#ifndef DVFS_HPP
+#define DVFS_HPP
+
+#include <Task.hpp>
+#include <tuple>
+#include <vector>
+
+namespace DVFS {
+/* Frequency selection policies for EDF scheduled systems.
+   Each returns the required fraction of nominal frequency, to be
+   applied with TaskSystem::setFrequency.
+ */
+double staticSlowdown(double util, double capacity);
+
+double ccEDF(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &ready,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &completed,
+    double capacity);
+
+double laEDF(
+    time_t t,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &ready,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &completed,
+    double capacity);
+}; // namespace DVFS
+
+#endif
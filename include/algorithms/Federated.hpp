@@ -0,0 +1,28 @@
+#ifndef FEDERATED_HPP
+#define FEDERATED_HPP
+
+#include <Task.hpp>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace Federated {
+struct Federation {
+  std::map<int, int> dedicated; // Processors of each heavy task, by id
+  int shared{0};                // Processors left to the light tasks
+  bool feasible{false};
+};
+
+Federation
+federate(const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const int &m);
+
+std::vector<int>
+schedule(time_t t, const int &m,
+         const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const Federation &federation);
+}; // namespace Federated
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef MIXED_CRITICALITY_HPP
+#define MIXED_CRITICALITY_HPP
+
+#include <Task.hpp>
+#include <tuple>
+#include <vector>
+
+namespace MixedCriticality {
+struct Utilization {
+  double LO{0.0};   // LO tasks at their (LO) WCET
+  double HILO{0.0}; // HI tasks at their LO WCET
+  double HI{0.0};   // HI tasks at their HI WCET
+};
+
+Utilization utilization(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states);
+
+double scaling(const Utilization &util, double capacity = 1.0);
+
+bool schedulable(const Utilization &util, double capacity = 1.0);
+
+bool AMCrtb(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states);
+
+std::vector<int>
+EDFVD(time_t t, const int &m,
+      const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+          &states,
+      double x, int mode);
+
+std::vector<int>
+AMC(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states);
+}; // namespace MixedCriticality
+
+#endif
@@ -1,19 +1,20 @@
 #ifndef PFAIR_HPP
 #define PFAIR_HPP
 
+#include <Kernels.hpp>
 #include <Task.hpp>
 #include <cmath>
 #include <iostream>
 #include <vector>
 
 namespace PFair {
-auto Lag = [](time_t t, time_t C, time_t Ct, double U, time_t releases) {
+inline auto Lag = [](time_t t, time_t C, time_t Ct, double U, time_t releases) {
   return (t * U) - ((releases * C) - Ct);
 };
 
 template <typename T> int Sgn(T val) { return (T(0) < val) - (val < T(0)); }
 
-auto Symbol = [](time_t t, time_t C, double U) {
+inline auto Symbol = [](time_t t, time_t C, double U) {
   double value = ((t + 1) * U) - std::floor(t * U) - 1;
   return Sgn(value);
 };
@@ -29,6 +30,24 @@ int getSymbol(time_t t, const Task::Parameters &params,
 
 int getSymbol(const Task::Parameters &params, const Task::Attributes &attrs);
 
+struct Batch {
+  /* Packed inputs of the lag and symbol kernel, one entry per task.
+   */
+  std::vector<double> U;
+  std::vector<double> W; // Work done so far, (releases * C) - Ct
+  std::vector<double> O; // Join time, lags are measured from it
+};
+
+struct Classes {
+  /* Bitmasks over ready tasks, by index.
+   */
+  Kernels::Mask urgent;
+  Kernels::Mask tnegru;
+  Kernels::Mask contending;
+};
+
+void classify(time_t t, const Batch &batch, Classes &classes);
+
 std::vector<int>
 PF(time_t t, const int &m,
    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
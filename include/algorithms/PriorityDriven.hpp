@@ -0,0 +1,46 @@
+#ifndef PRIORITY_DRIVEN_HPP
+#define PRIORITY_DRIVEN_HPP
+
+#include <Task.hpp>
+#include <functional>
+#include <vector>
+
+namespace PriorityDriven {
+using Priority = std::function<time_t(const Task::Parameters &,
+                                      const Task::Attributes &)>;
+
+// Smaller values run first
+inline auto Deadline = [](const Task::Parameters &params,
+                          const Task::Attributes &attrs) { return attrs.Dt; };
+
+inline auto RelativeDeadline = [](const Task::Parameters &params,
+                                  const Task::Attributes &attrs) {
+  return params.D;
+};
+
+inline auto Laxity = [](const Task::Parameters &params,
+                        const Task::Attributes &attrs) { return attrs.Lt; };
+
+std::vector<int>
+schedule(const int &m,
+         const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const Priority &priority);
+
+std::vector<int>
+EDF(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states);
+
+std::vector<int>
+DM(time_t t, const int &m,
+   const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+       &states);
+
+std::vector<int>
+LLF(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states);
+}; // namespace PriorityDriven
+
+#endif
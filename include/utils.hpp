@@ -1,6 +1,8 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include <Arena.hpp>
+#include <DagTask.hpp>
 #include <algorithm>
 #include <fstream>
 #include <iostream>
@@ -18,7 +20,8 @@ void copy(std::vector<std::unique_ptr<T>> &dest,
       [](const auto &entity) { return std::make_unique<T>(*entity); });
 }
 
-template <class T> void refresh(std::vector<std::unique_ptr<T>> &v) {
+template <class T, class D>
+void refresh(std::vector<std::unique_ptr<T, D>> &v) {
   /* Purges null (dispatched) entities.
    */
   v.erase(std::remove_if(v.begin(), v.end(),
@@ -26,8 +29,20 @@ template <class T> void refresh(std::vector<std::unique_ptr<T>> &v) {
           v.end());
 }
 
-std::vector<std::tuple<time_t, time_t>>
-loadTaskset(const std::string &filename) {
+struct TaskSpec {
+  time_t C;
+  time_t T;
+  time_t D;
+  std::vector<DagTask::Node> nodes; // Empty for sequential tasks
+};
+
+inline std::vector<TaskSpec> loadTaskset(const std::string &filename) {
+  /* Reads a taskset: utilization, task count, then one "C, T" line
+     per sequential task. A DAG task is given as "DAG T, D, V" and
+     V node lines "C: successor successor ...", with nodes numbered
+     from 0 in topological order. A successor out of that order
+     rejects the whole file.
+   */
   std::ifstream filestream(filename);
   if (!filestream.is_open()) {
     std::cout << "Failed to open file: " << filename << std::endl;
@@ -41,14 +56,39 @@ loadTaskset(const std::string &filename) {
   std::getline(filestream, line);
   auto N = std::stoi(line);
 
-  std::vector<std::tuple<time_t, time_t>> tasks;
+  std::vector<TaskSpec> tasks;
   for (int i = 0; i < N; i++) {
     std::getline(filestream, line);
     std::istringstream linestream(line);
-    time_t C, T;
+    time_t C, T, D;
+    int V;
     char sep;
-    if (linestream >> C >> sep >> T) {
-      tasks.emplace_back(C, T);
+    if (line.rfind("DAG", 0) == 0) {
+      std::string tag;
+      if (!(linestream >> tag >> T >> sep >> D >> sep >> V)) {
+        continue;
+      }
+
+      TaskSpec task{0, T, D, std::vector<DagTask::Node>(V)};
+      for (int v = 0; v < V; v++) {
+        auto &node = task.nodes[v];
+        std::getline(filestream, line);
+        std::istringstream nodestream(line);
+        nodestream >> node.C >> sep;
+        int successor;
+        while (nodestream >> successor) {
+          if (successor <= v || successor >= V) {
+            std::cout << "Invalid successor " << successor << " of node " << v
+                      << " in file: " << filename << std::endl;
+            return {};
+          }
+          node.successors.emplace_back(successor);
+        }
+        task.C += node.C;
+      }
+      tasks.emplace_back(std::move(task));
+    } else if (linestream >> C >> sep >> T) {
+      tasks.push_back({C, T, T, {}});
     }
   }
 
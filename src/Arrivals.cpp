@@ -0,0 +1,53 @@
+#include <Arrivals.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+PoissonArrivals::PoissonArrivals(double interarrival, double work, long count,
+                                 unsigned seed)
+    : _interarrival(1.0 / interarrival), _work(1.0 / work), _count(count),
+      _seed(seed), _rng(seed), _left(count) {}
+
+bool PoissonArrivals::next(Arrival &arrival) {
+  if (_left == 0) {
+    return false;
+  }
+  _left -= 1;
+
+  _t += _interarrival(_rng);
+  arrival.time = static_cast<time_t>(std::ceil(_t));
+  arrival.work = std::max<time_t>(std::ceil(_work(_rng)), 1);
+  return true;
+}
+
+void PoissonArrivals::rewind() {
+  _rng.seed(_seed);
+  _interarrival.reset();
+  _work.reset();
+  _t = 0;
+  _left = _count;
+}
+
+FileArrivals::FileArrivals(const std::string &filename) : _file(filename) {
+  if (!_file.is_open()) {
+    std::cout << "Failed to open file: " << filename << std::endl;
+  }
+}
+
+bool FileArrivals::next(Arrival &arrival) {
+  std::string line;
+  while (std::getline(_file, line)) {
+    std::istringstream linestream(line);
+    char sep;
+    if (linestream >> arrival.time >> sep >> arrival.work) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FileArrivals::rewind() {
+  _file.clear();
+  _file.seekg(0);
+}
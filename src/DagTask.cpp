@@ -0,0 +1,151 @@
+#include <DagTask.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+std::vector<time_t> DagTask::tails(const std::vector<Node> &nodes) {
+  /* Longest path from each node to a sink, in one backward pass.
+   */
+  std::vector<time_t> tail(nodes.size(), 0);
+  for (int v = nodes.size() - 1; v >= 0; v--) {
+    time_t longest = 0;
+    for (auto w : nodes[v].successors) {
+      assert(w > v && w < nodes.size()); // Nodes are in topological order
+      longest = std::max(longest, tail[w]);
+    }
+    tail[v] = nodes[v].C + longest;
+  }
+  return tail;
+}
+
+Task::Parameters DagTask::parameters(time_t T, time_t D,
+                                     const std::vector<Node> &nodes,
+                                     time_t O) {
+  return parameters(T, D, nodes, tails(nodes), O);
+}
+
+Task::Parameters DagTask::parameters(time_t T, time_t D,
+                                     const std::vector<Node> &nodes,
+                                     const std::vector<time_t> &tail,
+                                     time_t O) {
+  /* Derives task parameters of a DAG: C is its volume
+     (total work) and CP its longest path.
+   */
+  time_t volume = 0;
+  for (const auto &node : nodes) {
+    volume += node.C;
+  }
+
+  Parameters params(volume, T, D, O);
+  params.CP = tail.empty() ? 0 : *std::max_element(tail.begin(), tail.end());
+  return params;
+}
+
+DagTask::DagTask(time_t T, time_t D, std::vector<Node> nodes, time_t O)
+    // Braces evaluate in order, the tails before the nodes move
+    : DagTask{T, D, tails(nodes), std::move(nodes), O} {}
+
+DagTask::DagTask(time_t T, time_t D, std::vector<time_t> tail,
+                 std::vector<Node> nodes, time_t O)
+    : Task(parameters(T, D, nodes, tail, O), true), _nodes(std::move(nodes)),
+      _tail(std::move(tail)) {
+  /* Precomputes in-degrees, then starts the first job.
+   */
+  _predecessors.assign(_nodes.size(), 0);
+  for (const auto &node : _nodes) {
+    for (auto w : node.successors) {
+      _predecessors[w] += 1;
+    }
+  }
+  reset();
+}
+
+void DagTask::reset(bool start) {
+  resetNodes();
+  Task::reset(start);
+}
+
+void DagTask::skip() {
+  /* Abandons the nodes of the current job along with its budget.
+   */
+  std::fill(_remaining.begin(), _remaining.end(), 0);
+  _frontier.clear();
+  _attrs.Nt = 0;
+  _span = 0;
+  Task::skip();
+}
+
+void DagTask::resetNodes() {
+  /* Releases a new job: all nodes pending, sources ready.
+   */
+  _indegree = _predecessors;
+  _remaining.resize(_nodes.size());
+  _residues.assign(_nodes.size(), 0.0);
+  _frontier.clear();
+  for (int v = 0; v < _nodes.size(); v++) {
+    _remaining[v] = _nodes[v].C;
+    if (_indegree[v] == 0) {
+      _frontier.emplace_back(v);
+    }
+  }
+  _attrs.Nt = _frontier.size();
+  updateSpan();
+}
+
+void DagTask::updateSpan() {
+  /* Every unfinished node descends from a frontier node, so the
+     remaining critical path is found from the frontier alone.
+   */
+  _span = 0;
+  for (auto v : _frontier) {
+    _span = std::max(_span, _tail[v] - (_nodes[v].C - _remaining[v]));
+  }
+}
+
+void DagTask::allocateProcessor(ProcessorPtr processor) {
+  _processors.emplace_back(std::move(processor));
+}
+
+ProcessorPtr DagTask::releaseProcessor() {
+  auto processor = std::move(_processors.back());
+  _processors.pop_back();
+  return processor;
+}
+
+void DagTask::execute(time_t dt) {
+  /* Runs the first frontier nodes, one per allocated processor.
+     Finished nodes release their successors through in-degree
+     counters, so the graph is never rescanned.
+   */
+  auto running = std::min(_processors.size(), _frontier.size());
+  time_t consumed = 0;
+  for (int k = 0; k < running; k++) {
+    auto v = _frontier[k];
+    double work = dt * speedOn(*_processors[k]) + _residues[v];
+    auto units = static_cast<time_t>(std::floor(work));
+    _residues[v] = work - units;
+    auto left = pay(units); // Overheads charged to the job run first
+    auto done = std::min(left, _remaining[v]);
+    _remaining[v] -= done;
+    consumed += (units - left) + done;
+  }
+
+  // Keep unfinished nodes in order, then append the newly ready
+  auto end = std::stable_partition(
+      _frontier.begin(), _frontier.begin() + running,
+      [this](const int &v) { return _remaining[v] > 0; });
+  std::vector<int> finished(end, _frontier.begin() + running);
+  _frontier.erase(end, _frontier.begin() + running);
+  for (auto v : finished) {
+    for (auto w : _nodes[v].successors) {
+      if (--_indegree[w] == 0) {
+        _frontier.emplace_back(w);
+      }
+    }
+  }
+
+  _attrs.Ct -= consumed;
+  _attrs.Nt = _frontier.size();
+  _status = _attrs.Ct > 0 ? Status::RUNNING : Status::COMPLETED;
+  updateSpan();
+}
@@ -127,3 +127,36 @@ void Display::clearLists() {
   wclear(_runningWin);
   wrefresh(_runningWin);
 }
+
+void Display::drawTime(time_t from, time_t zoom) {
+  /* Labels every tenth column with the time it starts at.
+   */
+  wclear(_timeWin);
+  for (int c = 0; c < _traceWidth - 2; c += 10) {
+    mvwprintw(_timeWin, 0, c + 1, "%ld", from + (c * zoom));
+  }
+  wrefresh(_timeWin);
+}
+
+void Display::drawReplay(time_t from, time_t zoom,
+                         const std::vector<std::vector<int>> &view) {
+  /* Redraws the traces from a replayed window, one column per
+     `zoom` ticks, instead of scrolling in live updates.
+   */
+  for (int i = 0; i < _numProcessors && i < view.size(); i++) {
+    auto win = _traceWins[i];
+    werase(win);
+    box(win, 0, 0);
+    for (int c = 0; c < view[i].size() && c < (_traceWidth - 2); c++) {
+      if (view[i][c] == 0) {
+        continue;
+      }
+      auto color = COLOR_PAIR(view[i][c]);
+      wattron(win, color);
+      mvwprintw(win, 1, (c + 1), "|");
+      wattroff(win, color);
+    }
+    wrefresh(win);
+  }
+  drawTime(from, zoom);
+}
@@ -0,0 +1,374 @@
+#include <Kernels.hpp>
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86 1
+#endif
+
+namespace Kernels {
+namespace {
+Level _level = detect();
+
+// Release beyond any time a compact batch can step to
+constexpr int32_t unreachable = INT32_MAX;
+
+template <typename Time>
+void advanceScalar(Lanes<Time> &lanes, Time dt, uint64_t *misses,
+                   uint64_t *releases, std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; i++) {
+    lanes.t[i] += dt;
+    lanes.Dt[i] -= dt;
+    lanes.Lt[i] = lanes.Dt[i] - lanes.Ct[i];
+    lanes.Rt[i] = lanes.D[i] - lanes.Lt[i];
+
+    uint64_t bit = uint64_t(1) << (i & 63);
+    if (lanes.Lt[i] < 0 && lanes.Ct[i] > 0) {
+      misses[i >> 6] |= bit;
+    }
+    if (lanes.t[i] >= lanes.next[i]) {
+      releases[i >> 6] |= bit;
+    }
+  }
+}
+
+#if KERNELS_X86
+static_assert(sizeof(time_t) == sizeof(int64_t),
+              "Vector kernels expect 64-bit time_t");
+
+template <typename T>
+__attribute__((target("sse4.2"))) inline __m128i
+load128(const std::vector<T> &v, std::size_t i) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(v.data() + i));
+}
+
+template <typename T>
+__attribute__((target("sse4.2"))) inline void
+store128(std::vector<T> &v, std::size_t i, __m128i x) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(v.data() + i), x);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) inline __m256i
+load256(const std::vector<T> &v, std::size_t i) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v.data() + i));
+}
+
+template <typename T>
+__attribute__((target("avx2"))) inline void
+store256(std::vector<T> &v, std::size_t i, __m256i x) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(v.data() + i), x);
+}
+
+__attribute__((target("sse4.2"))) void
+advanceSSE42(Lanes<time_t> &lanes, time_t dt, std::size_t n,
+             uint64_t *misses, uint64_t *releases) {
+  const __m128i vdt = _mm_set1_epi64x(dt);
+  const __m128i zero = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i t = _mm_add_epi64(load128(lanes.t, i), vdt);
+    __m128i Dt = _mm_sub_epi64(load128(lanes.Dt, i), vdt);
+    __m128i Ct = load128(lanes.Ct, i);
+    __m128i Lt = _mm_sub_epi64(Dt, Ct);
+    __m128i Rt = _mm_sub_epi64(load128(lanes.D, i), Lt);
+    store128(lanes.t, i, t);
+    store128(lanes.Dt, i, Dt);
+    store128(lanes.Lt, i, Lt);
+    store128(lanes.Rt, i, Rt);
+
+    // Completed jobs past a constrained deadline are not misses
+    auto missBits = _mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(
+        _mm_cmpgt_epi64(zero, Lt), _mm_cmpgt_epi64(Ct, zero))));
+    auto pendingBits = _mm_movemask_pd(
+        _mm_castsi128_pd(_mm_cmpgt_epi64(load128(lanes.next, i), t)));
+    misses[i >> 6] |= uint64_t(missBits) << (i & 63);
+    releases[i >> 6] |= uint64_t(~pendingBits & 0x3) << (i & 63);
+  }
+  advanceScalar(lanes, dt, misses, releases, i, n);
+}
+
+__attribute__((target("sse4.2"))) void
+advanceSSE42(Lanes<int32_t> &lanes, int32_t dt, std::size_t n,
+             uint64_t *misses, uint64_t *releases) {
+  const __m128i vdt = _mm_set1_epi32(dt);
+  const __m128i zero = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i t = _mm_add_epi32(load128(lanes.t, i), vdt);
+    __m128i Dt = _mm_sub_epi32(load128(lanes.Dt, i), vdt);
+    __m128i Ct = load128(lanes.Ct, i);
+    __m128i Lt = _mm_sub_epi32(Dt, Ct);
+    __m128i Rt = _mm_sub_epi32(load128(lanes.D, i), Lt);
+    store128(lanes.t, i, t);
+    store128(lanes.Dt, i, Dt);
+    store128(lanes.Lt, i, Lt);
+    store128(lanes.Rt, i, Rt);
+
+    auto missBits = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(
+        _mm_cmpgt_epi32(zero, Lt), _mm_cmpgt_epi32(Ct, zero))));
+    auto pendingBits = _mm_movemask_ps(
+        _mm_castsi128_ps(_mm_cmpgt_epi32(load128(lanes.next, i), t)));
+    misses[i >> 6] |= uint64_t(missBits) << (i & 63);
+    releases[i >> 6] |= uint64_t(~pendingBits & 0xF) << (i & 63);
+  }
+  advanceScalar(lanes, dt, misses, releases, i, n);
+}
+
+__attribute__((target("avx2"))) void
+advanceAVX2(Lanes<time_t> &lanes, time_t dt, std::size_t n, uint64_t *misses,
+            uint64_t *releases) {
+  const __m256i vdt = _mm256_set1_epi64x(dt);
+  const __m256i zero = _mm256_setzero_si256();
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i t = _mm256_add_epi64(load256(lanes.t, i), vdt);
+    __m256i Dt = _mm256_sub_epi64(load256(lanes.Dt, i), vdt);
+    __m256i Ct = load256(lanes.Ct, i);
+    __m256i Lt = _mm256_sub_epi64(Dt, Ct);
+    __m256i Rt = _mm256_sub_epi64(load256(lanes.D, i), Lt);
+    store256(lanes.t, i, t);
+    store256(lanes.Dt, i, Dt);
+    store256(lanes.Lt, i, Lt);
+    store256(lanes.Rt, i, Rt);
+
+    // Completed jobs past a constrained deadline are not misses
+    auto missBits = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_and_si256(
+        _mm256_cmpgt_epi64(zero, Lt), _mm256_cmpgt_epi64(Ct, zero))));
+    auto pendingBits = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(load256(lanes.next, i), t)));
+    misses[i >> 6] |= uint64_t(missBits) << (i & 63);
+    releases[i >> 6] |= uint64_t(~pendingBits & 0xF) << (i & 63);
+  }
+  advanceScalar(lanes, dt, misses, releases, i, n);
+}
+
+__attribute__((target("avx2"))) void
+advanceAVX2(Lanes<int32_t> &lanes, int32_t dt, std::size_t n,
+            uint64_t *misses, uint64_t *releases) {
+  const __m256i vdt = _mm256_set1_epi32(dt);
+  const __m256i zero = _mm256_setzero_si256();
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i t = _mm256_add_epi32(load256(lanes.t, i), vdt);
+    __m256i Dt = _mm256_sub_epi32(load256(lanes.Dt, i), vdt);
+    __m256i Ct = load256(lanes.Ct, i);
+    __m256i Lt = _mm256_sub_epi32(Dt, Ct);
+    __m256i Rt = _mm256_sub_epi32(load256(lanes.D, i), Lt);
+    store256(lanes.t, i, t);
+    store256(lanes.Dt, i, Dt);
+    store256(lanes.Lt, i, Lt);
+    store256(lanes.Rt, i, Rt);
+
+    auto missBits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(
+        _mm256_cmpgt_epi32(zero, Lt), _mm256_cmpgt_epi32(Ct, zero))));
+    auto pendingBits = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(load256(lanes.next, i), t)));
+    misses[i >> 6] |= uint64_t(missBits) << (i & 63);
+    releases[i >> 6] |= uint64_t(~pendingBits & 0xFF) << (i & 63);
+  }
+  advanceScalar(lanes, dt, misses, releases, i, n);
+}
+#endif
+
+template <typename Time>
+void step(Lanes<Time> &lanes, Time dt, std::size_t n, uint64_t *misses,
+          uint64_t *releases) {
+  switch (_level) {
+#if KERNELS_X86
+  case Level::AVX2:
+    advanceAVX2(lanes, dt, n, misses, releases);
+    break;
+  case Level::SSE42:
+    advanceSSE42(lanes, dt, n, misses, releases);
+    break;
+#endif
+  default:
+    advanceScalar(lanes, dt, misses, releases, 0, n);
+  }
+}
+} // namespace
+
+void Batch::resize(std::size_t n) {
+  _size = n;
+  if (compact()) {
+    quanta.resize(n);
+  } else {
+    times.resize(n);
+  }
+}
+
+void Batch::setScale(time_t quantum, time_t base) {
+  /* Converts the slots to units of quantum from base, or to 64-bit
+     times when quantum is 0. The batch stays wide when a slot does
+     not fit in quanta.
+   */
+  widen();
+  if (quantum == 0) {
+    return;
+  }
+
+  this->quantum = quantum;
+  this->base = base;
+  quanta.resize(_size);
+  for (std::size_t i = 0; i < _size; i++) {
+    if (!narrow(i, times.Ct[i], times.Dt[i], times.D[i], times.t[i],
+                times.next[i])) {
+      this->quantum = 0;
+      return;
+    }
+  }
+}
+
+void Batch::pack(std::size_t i, time_t Ct, time_t Dt, time_t D, time_t t,
+                 time_t next) {
+  /* Writes the time attributes of slot i, narrowed to quanta in a
+     compact batch, or widening the batch when they do not fit.
+     A next release of the maximum time never comes due.
+   */
+  if (compact()) {
+    if (narrow(i, Ct, Dt, D, t, next)) {
+      return;
+    }
+    widen();
+  }
+
+  times.Ct[i] = Ct;
+  times.Dt[i] = Dt;
+  times.D[i] = D;
+  times.t[i] = t;
+  times.next[i] = next;
+  times.Lt[i] = Dt - Ct;
+  times.Rt[i] = D - times.Lt[i];
+}
+
+bool Batch::narrow(std::size_t i, time_t Ct, time_t Dt, time_t D, time_t t,
+                   time_t next) {
+  /* Writes slot i in quanta if its times allow it. Releases are
+     checked at whole quanta, so the next one rounds up.
+   */
+  const auto q = quantum;
+  time_t narrow[4]{Ct, Dt, D, t - base};
+  auto ahead = next - base;
+  bool whole = true;
+  if (q != 1) { // Spares the divisions in the common unit quantum
+    for (auto &v : narrow) {
+      whole = whole && v % q == 0;
+      v /= q;
+    }
+    ahead = (ahead / q) + (ahead % q > 0);
+  }
+  if (next == std::numeric_limits<time_t>::max()) {
+    ahead = unreachable;
+  } else if (!fits(ahead)) {
+    return false;
+  }
+  if (!whole || !std::all_of(narrow, narrow + 4, fits)) {
+    return false;
+  }
+
+  quanta.Ct[i] = narrow[0];
+  quanta.Dt[i] = narrow[1];
+  quanta.D[i] = narrow[2];
+  quanta.t[i] = narrow[3];
+  quanta.next[i] = ahead;
+  quanta.Lt[i] = narrow[1] - narrow[0];
+  quanta.Rt[i] = narrow[2] - quanta.Lt[i];
+  return true;
+}
+
+Slot Batch::slot(std::size_t i) const {
+  /* Reads back the stepped attributes of slot i in time units.
+   */
+  if (compact()) {
+    const auto q = quantum;
+    return {base + (quanta.t[i] * q), quanta.Dt[i] * q, quanta.Lt[i] * q,
+            quanta.Rt[i] * q};
+  }
+  return {times.t[i], times.Dt[i], times.Lt[i], times.Rt[i]};
+}
+
+void Batch::move(std::size_t from, std::size_t to) {
+  /* Copies slot from over slot to, to fill the hole a task leaves.
+   */
+  auto copy = [from, to](auto &lanes) {
+    for (auto v : {&lanes.Ct, &lanes.Dt, &lanes.D, &lanes.t, &lanes.next,
+                   &lanes.Lt, &lanes.Rt}) {
+      (*v)[to] = (*v)[from];
+    }
+  };
+  if (compact()) {
+    copy(quanta);
+  } else {
+    copy(times);
+  }
+}
+
+void Batch::widen() {
+  /* Falls back to 64-bit times, converting all slots.
+   */
+  if (!compact()) {
+    return;
+  }
+
+  times.resize(_size);
+  const auto q = quantum;
+  for (std::size_t i = 0; i < _size; i++) {
+    times.Ct[i] = quanta.Ct[i] * q;
+    times.Dt[i] = quanta.Dt[i] * q;
+    times.D[i] = quanta.D[i] * q;
+    times.t[i] = base + (quanta.t[i] * q);
+    times.next[i] = quanta.next[i] == unreachable
+                        ? std::numeric_limits<time_t>::max()
+                        : base + (quanta.next[i] * q);
+    times.Lt[i] = quanta.Lt[i] * q;
+    times.Rt[i] = quanta.Rt[i] * q;
+  }
+  quantum = 0;
+}
+
+Level detect() {
+  /* Picks the widest instruction set supported by the running CPU.
+   */
+#if KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return Level::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return Level::SSE42;
+  }
+#endif
+  return Level::SCALAR;
+}
+
+Level level() { return _level; }
+
+void setLevel(Level level) { _level = std::min(level, detect()); }
+
+void advance(Batch &batch, time_t dt, Mask &misses, Mask &releases) {
+  /* Steps packed tasks by dt: advances their clocks, recomputes
+     laxity and response and flags deadline misses and due releases.
+   */
+  const std::size_t words = (batch.size() + 63) / 64;
+  misses.assign(words, 0);
+  releases.assign(words, 0);
+
+  if (batch.compact() &&
+      (dt % batch.quantum != 0 || !fits(dt / batch.quantum))) {
+    batch.widen();
+  }
+  if (batch.compact()) {
+    step<int32_t>(batch.quanta, dt / batch.quantum, batch.size(),
+                  misses.data(), releases.data());
+  } else {
+    step<time_t>(batch.times, dt, batch.size(), misses.data(),
+                 releases.data());
+  }
+}
+}; // namespace Kernels
@@ -0,0 +1,189 @@
+#include <LockManager.hpp>
+#include <algorithm>
+#include <cassert>
+
+int LockManager::addResource() {
+  _resources.emplace_back(_resources.size() + 1);
+  return _resources.back().id();
+}
+
+void LockManager::use(int id, time_t D) {
+  /* Registers a task with relative deadline D as a user of the
+     resource, lowering its ceiling as needed.
+   */
+  assert(id > 0 && id <= _resources.size());
+  auto &ceiling = resource(id)._ceiling;
+  ceiling = std::min(ceiling, D);
+}
+
+bool LockManager::passes(const Task &task) const {
+  /* Ceiling rule: the job's priority must be strictly higher than
+     every ceiling of resources currently locked.
+   */
+  return _ceilings.empty() || task.params().D < _ceilings.begin()->first;
+}
+
+bool LockManager::admit(Task *task, time_t t) {
+  /* SRP start rule for a job that has not executed yet.
+   */
+  if (_protocol != Protocol::SRP || passes(*task)) {
+    return true;
+  }
+  hold(task, t);
+  return false;
+}
+
+void LockManager::hold(Task *task, time_t t) {
+  /* Suspends the job under the ceilings, in priority order and FIFO
+     among equals.
+   */
+  auto at = std::upper_bound(
+      _pending.begin(), _pending.end(), task->params().D,
+      [](const time_t &D, const SharedResource::Waiter &waiter) {
+        return D < waiter.task->params().D;
+      });
+  _pending.insert(at, {task, t});
+  task->suspend();
+}
+
+LockManager::Outcome LockManager::request(Task *task, time_t t) {
+  /* Requests the resource of the task's pending critical section.
+   */
+  auto &r = resource(task->pendingSection()->resource);
+
+  if (_protocol == Protocol::PCP) {
+    if (!r.locked() && passes(*task)) {
+      grant(r, task, t, t);
+      return Outcome::GRANTED;
+    }
+    hold(task, t);
+    return Outcome::SUSPEND;
+  }
+
+  if (!r.locked()) {
+    grant(r, task, t, t);
+    return Outcome::GRANTED;
+  }
+
+  r._waiters.push_back({task, t});
+  if (_protocol == Protocol::FMLP_PLUS) {
+    task->suspend();
+    return Outcome::SUSPEND;
+  }
+  task->spin();
+  return Outcome::SPIN;
+}
+
+void LockManager::grant(SharedResource &r, Task *task, time_t t,
+                        time_t since) {
+  r._owner = task;
+  task->lock(r.id());
+  _ceilings.emplace(r._ceiling, r.id());
+
+  r._stats.acquisitions += 1;
+  if (t > since) {
+    r._stats.contended += 1;
+    r._stats.blocked += t - since;
+    r._stats.maxBlocked = std::max(r._stats.maxBlocked, t - since);
+  }
+}
+
+bool LockManager::release(Task *task, time_t t) {
+  /* Releases the resource held by the task and hands it on.
+     Returns whether a suspended job was woken.
+   */
+  auto &r = resource(task->held());
+  assert(r._owner == task);
+
+  _ceilings.erase(_ceilings.find({r._ceiling, r.id()}));
+  r._owner = nullptr;
+  task->unlock();
+
+  auto woken = false;
+  if (!r._waiters.empty()) {
+    auto waiter = r._waiters.front();
+    r._waiters.pop_front();
+    woken = waiter.task->suspended();
+    grant(r, waiter.task, t, waiter.since);
+  }
+
+  if (!_pending.empty()) {
+    woken = wake(t) || woken;
+  }
+  return woken;
+}
+
+bool LockManager::wake(time_t t) {
+  /* Retries jobs held back by the ceiling, in priority order.
+     Returns whether any was woken.
+   */
+  auto pending = _pending.size();
+  _pending.erase(
+      std::remove_if(_pending.begin(), _pending.end(),
+                     [this, t](const SharedResource::Waiter &waiter) {
+                       auto task = waiter.task;
+                       if (!passes(*task)) {
+                         return false;
+                       }
+
+                       if (_protocol == Protocol::SRP) {
+                         _startBlocked += t - waiter.since;
+                         task->resume();
+                         return true;
+                       }
+
+                       auto &r = resource(task->pendingSection()->resource);
+                       if (r.locked()) {
+                         return false;
+                       }
+                       grant(r, task, t, waiter.since);
+                       return true;
+                     }),
+      _pending.end());
+  return _pending.size() != pending;
+}
+
+void LockManager::spun(const Task &task, time_t dt) {
+  resource(task.pendingSection()->resource)._stats.spin += dt;
+}
+
+bool LockManager::boosted(const Task &task) const {
+  /* Whether the holder must run ahead of the scheduler's choice.
+   */
+  if (task.held() < 0) {
+    return false;
+  }
+  if (_protocol == Protocol::FMLP_PLUS || _protocol == Protocol::MRSP) {
+    return true;
+  }
+  // Inheritance: only while the holder blocks someone
+  const auto &r = _resources[task.held() - 1];
+  if (!r._waiters.empty()) {
+    return true;
+  }
+  for (const auto &waiter : _pending) {
+    auto D = waiter.task->params().D;
+    if (D >= task.params().D) {
+      break; // Inheriting a lower priority changes nothing
+    }
+    // Users of the resource are blocked by its ceiling too
+    if (D >= r._ceiling) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void LockManager::reset() {
+  /* Drops all holders, waiters and statistics,
+     keeping resources and their ceilings.
+   */
+  for (auto &r : _resources) {
+    r._owner = nullptr;
+    r._waiters.clear();
+    r._stats = SharedResource::Stats();
+  }
+  _ceilings.clear();
+  _pending.clear();
+  _startBlocked = 0;
+}
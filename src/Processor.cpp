@@ -0,0 +1,48 @@
+#include <Processor.hpp>
+#include <algorithm>
+#include <cassert>
+
+void Processor::setOperatingPoints(std::vector<OperatingPoint> points,
+                                   PowerModel model) {
+  /* Sets the available frequency/voltage pairs and the power model.
+     Starts at the highest (nominal) point.
+   */
+  assert(!points.empty());
+  std::sort(points.begin(), points.end(),
+            [](const OperatingPoint &a, const OperatingPoint &b) {
+              return a.frequency < b.frequency;
+            });
+
+  _points = std::move(points);
+  _model = model;
+  _level = _points.size() - 1;
+}
+
+void Processor::setLevel(int level) {
+  assert(level >= 0 && level < _points.size());
+  _level = level;
+}
+
+void Processor::setFrequency(double frequency) {
+  /* Selects the lowest operating point at or above the requested
+     frequency, or the highest one if none is fast enough.
+   */
+  _level = _points.size() - 1;
+  for (int i = 0; i < _points.size(); i++) {
+    if (_points[i].frequency >= frequency) {
+      _level = i;
+      break;
+    }
+  }
+}
+
+double Processor::power(bool busy) const {
+  /* Static power plus, when busy, dynamic power Ceff * V^2 * f.
+   */
+  if (!busy) {
+    return _model.Pstatic;
+  }
+  const auto &point = _points[_level];
+  return _model.Pstatic +
+         (_model.Ceff * point.voltage * point.voltage * point.frequency);
+}
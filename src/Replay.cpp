@@ -0,0 +1,266 @@
+#include <Replay.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+Recorder::Recorder(const std::string &filename, int m)
+    : _file(filename, std::ios::binary | std::ios::trunc) {
+  if (!_file.is_open()) {
+    std::cout << "Failed to open file: " << filename << std::endl;
+    return;
+  }
+
+  RecordHeader header;
+  header.m = m;
+  _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  _record.resize((2 * sizeof(int64_t)) + (m * sizeof(int32_t)));
+}
+
+void Recorder::write(time_t t, time_t dt, const std::vector<int> &ids) {
+  int64_t times[2]{t, dt};
+  std::memcpy(_record.data(), times, sizeof(times));
+  for (int p = 0; p < ids.size(); p++) {
+    int32_t id = ids[p];
+    std::memcpy(_record.data() + sizeof(times) + (p * sizeof(id)), &id,
+                sizeof(id));
+  }
+  _file.write(_record.data(), _record.size());
+}
+
+Replay::Replay(const std::string &filename)
+    : _file(filename, std::ios::binary) {
+  /* Validates the header, then builds the checkpoint index and the
+     summaries in one sequential pass over the steps.
+   */
+  RecordHeader header;
+  if (!_file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, RecordHeader().magic, 4) != 0 ||
+      header.m <= 0) {
+    std::cout << "Not a recorded run: " << filename << std::endl;
+    return;
+  }
+
+  _m = header.m;
+  _recordSize = (2 * sizeof(int64_t)) + (_m * sizeof(int32_t));
+  _record.resize(_recordSize);
+
+  _file.seekg(0, std::ios::end);
+  _steps = (static_cast<long>(_file.tellg()) - sizeof(header)) / _recordSize;
+  if (_steps > 0) {
+    summarize();
+  }
+}
+
+void Replay::summarize() {
+  /* Reads every step once, a stride at a time: notes the
+     checkpoints, sums the time each task held each processor over
+     blocks of the first level, then folds blocks into the levels
+     above. Upper levels add up the longest holders of their blocks,
+     so they are coarse.
+   */
+  // Blocks have few distinct holders, a list beats a map
+  std::vector<std::vector<std::pair<int, time_t>>> shares(_m);
+  auto add = [&shares](int p, int id, time_t held) {
+    auto share = std::find_if(shares[p].begin(), shares[p].end(),
+                              [id](const auto &s) { return s.first == id; });
+    if (share == shares[p].end()) {
+      shares[p].emplace_back(id, held);
+    } else {
+      share->second += held;
+    }
+  };
+  auto settle = [&](Level &level, time_t from, time_t to) {
+    level.from.emplace_back(from);
+    level.to.emplace_back(to);
+    for (int p = 0; p < _m; p++) {
+      auto longest = std::max_element(
+          shares[p].begin(), shares[p].end(),
+          [](const auto &a, const auto &b) { return a.second < b.second; });
+      level.ids.emplace_back(longest->first);
+      level.held.emplace_back(longest->second);
+      shares[p].clear();
+    }
+  };
+
+  _levels.push_back({_block});
+  std::vector<char> chunk(_stride * _recordSize);
+  _file.clear();
+  _file.seekg(sizeof(RecordHeader));
+  _cursor = -1;
+  Step step;
+  time_t start = 0;
+  for (long i = 0; i < _steps; i += _stride) {
+    auto n = std::min(_stride, _steps - i);
+    _file.read(chunk.data(), n * _recordSize);
+    _checkpoints.emplace_back(0);
+    for (long j = 0; j < n; j++) {
+      decode(chunk.data() + (j * _recordSize), step);
+      if (j == 0) {
+        _checkpoints.back() = step.t;
+      }
+      if ((i + j) % _block == 0) {
+        start = step.t;
+      }
+      for (int p = 0; p < _m; p++) {
+        add(p, step.ids[p], step.dt);
+      }
+      if ((i + j + 1) % _block == 0) {
+        settle(_levels[0], start, step.t + step.dt);
+      }
+    }
+  }
+  _begin = _checkpoints.front();
+  _end = step.t + step.dt;
+  for (auto &share : shares) {
+    share.clear(); // Of a last partial block, left to the steps
+  }
+
+  while (_levels.back().from.size() >= _fanout) {
+    auto &lower = _levels.back();
+    Level upper{lower.span * _fanout};
+    for (std::size_t b = 0; b + _fanout <= lower.from.size();
+         b += _fanout) {
+      for (auto k = b; k < b + _fanout; k++) {
+        for (int p = 0; p < _m; p++) {
+          add(p, lower.ids[(k * _m) + p], lower.held[(k * _m) + p]);
+        }
+      }
+      settle(upper, lower.from[b], lower.to[b + _fanout - 1]);
+    }
+    _levels.emplace_back(std::move(upper));
+  }
+}
+
+bool Replay::read(long index, Step &step) {
+  /* Reads one step, seeking only when not reading sequentially.
+   */
+  if (index < 0 || index >= _steps) {
+    return false;
+  }
+  if (index != _cursor) {
+    _file.clear();
+    _file.seekg(sizeof(RecordHeader) + (index * _recordSize));
+  }
+  if (!_file.read(_record.data(), _recordSize)) {
+    _cursor = -1;
+    return false;
+  }
+  _cursor = index + 1;
+  decode(_record.data(), step);
+  return true;
+}
+
+void Replay::decode(const char *record, Step &step) const {
+  int64_t times[2];
+  std::memcpy(times, record, sizeof(times));
+  step.t = times[0];
+  step.dt = times[1];
+  step.ids.resize(_m);
+  for (int p = 0; p < _m; p++) {
+    int32_t id;
+    std::memcpy(&id, record + sizeof(times) + (p * sizeof(id)), sizeof(id));
+    step.ids[p] = id;
+  }
+}
+
+long Replay::seek(time_t t) {
+  /* Finds the step running at time t: the checkpoint at or before
+     it, then a scan of at most one stride of steps.
+   */
+  auto checkpoint =
+      std::upper_bound(_checkpoints.begin(), _checkpoints.end(), t);
+  long index = std::max<long>(checkpoint - _checkpoints.begin() - 1, 0) *
+               _stride;
+
+  Step step;
+  while (read(index, step) && step.t + step.dt <= t) {
+    index += 1;
+  }
+  return std::min(index, _steps);
+}
+
+std::vector<std::vector<int>> Replay::window(time_t from, int columns,
+                                             time_t zoom) {
+  /* Summarizes the run from time `from` in columns of `zoom` ticks:
+     per processor, the task that held it longest in each column
+     (0 when mostly idle). Only the range is read, and a column
+     spanning whole blocks reads their summaries instead of steps.
+   */
+  std::vector<std::vector<int>> view(_m, std::vector<int>(columns, 0));
+  std::vector<std::map<int, time_t>> shares(_m);
+  auto until = from + (columns * zoom);
+  int column = 0;
+
+  auto settle = [&]() {
+    for (int p = 0; p < _m; p++) {
+      auto longest = std::max_element(
+          shares[p].begin(), shares[p].end(),
+          [](const auto &a, const auto &b) { return a.second < b.second; });
+      if (longest != shares[p].end()) {
+        view[p][column] = longest->first;
+      }
+      shares[p].clear();
+    }
+    column += 1;
+  };
+
+  long i = seek(from);
+  Step step;
+  while (i < _steps) {
+    auto k = widest(i, from, zoom, until);
+    if (k >= 0) {
+      const auto &level = _levels[k];
+      auto b = i / level.span;
+      auto c = (level.from[b] - from) / zoom;
+      while (column < c) {
+        settle();
+      }
+      for (int p = 0; p < _m; p++) {
+        shares[p][level.ids[(b * _m) + p]] += level.held[(b * _m) + p];
+      }
+      i += level.span;
+      continue;
+    }
+
+    if (!read(i++, step) || step.t >= until) {
+      break;
+    }
+    auto a = std::max(step.t, from);
+    auto b = std::min(step.t + step.dt, until);
+    while (a < b) {
+      auto c = (a - from) / zoom;
+      while (column < c) {
+        settle();
+      }
+      auto end = std::min(b, from + ((c + 1) * zoom));
+      for (int p = 0; p < _m; p++) {
+        shares[p][step.ids[p]] += end - a;
+      }
+      a = end;
+    }
+  }
+  while (column < columns) {
+    settle();
+  }
+  return view;
+}
+
+int Replay::widest(long index, time_t from, time_t zoom, time_t until) const {
+  /* Returns the highest level with a block starting at the step that
+     lies within a single column, or -1 when there is none.
+   */
+  for (int k = _levels.size() - 1; k >= 0; k--) {
+    const auto &level = _levels[k];
+    auto b = index / level.span;
+    if (index % level.span != 0 || b >= level.from.size() ||
+        level.from[b] < from) {
+      continue;
+    }
+    auto column = (level.from[b] - from) / zoom;
+    if (level.to[b] <= std::min(until, from + ((column + 1) * zoom))) {
+      return k;
+    }
+  }
+  return -1;
+}
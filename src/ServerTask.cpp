@@ -0,0 +1,190 @@
+#include <ServerTask.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+ServerTask::ServerTask(Kind kind, time_t Q, time_t T,
+                       std::unique_ptr<ArrivalStream> arrivals, time_t O)
+    : Task(Parameters(Q, T, T, O)), _kind(kind),
+      _arrivals(std::move(arrivals)) {
+  _polled = true; // Refills every step
+  setHistogram(1, 256);
+  reset();
+}
+
+void ServerTask::setHistogram(time_t width, std::size_t buckets) {
+  /* Sets the resolution of the response-time histogram, clearing it.
+   */
+  assert(width > 0 && buckets > 0);
+  _responses = ResponseTimes();
+  _responses.width = width;
+  _responses.buckets.assign(buckets, 0);
+}
+
+void ServerTask::reset(bool start) {
+  /* Restarts the server with a full budget (an empty one for CBS,
+     which recharges on the first arrival) and its stream rewound.
+   */
+  Task::reset(start);
+  if (!start) {
+    return;
+  }
+
+  _arrivals->rewind();
+  _more = _arrivals->next(_next);
+  _queue.clear();
+  _backlog = 0;
+  _budget = _kind == Kind::CBS ? 0 : _params.C;
+  _deadline = _params.O + (_kind == Kind::CBS ? 0 : _params.T);
+  _active = false;
+  _activation = _params.O;
+  _consumed = 0;
+  _replenishments.clear();
+  setHistogram(_responses.width, _responses.buckets.size());
+  refill();
+}
+
+void ServerTask::refill() {
+  /* Applies the replenishments and arrivals due by now, then exposes
+     the server to the scheduler: ready while active, with its
+     deadline and the budget it can use as remaining execution.
+   */
+  const auto Q = _params.C, T = _params.T;
+  if (_t >= _deadline && expire()) {
+    // Retiring at the end of its period, its bandwidth is free
+    _active = false;
+    _attrs.Dt = _deadline - _t;
+    _attrs.Ct = 0;
+    update(false);
+    return;
+  }
+  if (_kind == Kind::DEFERRABLE) {
+    while (_t >= _deadline) {
+      _budget = Q;
+      _deadline += T;
+    }
+  } else if (_kind == Kind::SPORADIC) {
+    while (!_replenishments.empty() && _replenishments.front().time <= _t) {
+      _budget += _replenishments.front().amount;
+      _replenishments.pop();
+    }
+  }
+
+  auto renew = !retiring(); // Else it serves out its current period
+  while (_more && _next.time <= _t) {
+    if (_kind == Kind::CBS && renew && _queue.empty() &&
+        _budget >= (_deadline - _t) * _params.U) {
+      _deadline = _t + T;
+      _budget = Q;
+    }
+    _queue.push({_next.time, _next.work});
+    _backlog += _next.work;
+    _more = _arrivals->next(_next);
+  }
+  if (_kind == Kind::CBS && renew && _budget == 0 && !_queue.empty()) {
+    _budget = Q;
+    _deadline += T;
+  }
+
+  auto active = !_queue.empty() && _budget > 0 && (renew || _active);
+  if (_kind == Kind::SPORADIC) {
+    if (_consumed > 0 && (!active || _t >= _deadline)) {
+      // The active period ends: what it used returns a period later
+      _replenishments.push({_activation + T, _consumed});
+      _consumed = 0;
+      _active = false;
+    }
+    if (active && !_active) {
+      _activation = _t;
+      _deadline = _t + T;
+    }
+  }
+
+  _active = active;
+  if (!active) {
+    _status = Status::COMPLETED;
+  } else if (_status == Status::COMPLETED) {
+    _status = Status::IDLE;
+  }
+  _attrs.Dt = _deadline - _t;
+  _attrs.Ct = span();
+  update(false);
+}
+
+time_t ServerTask::span() const {
+  if (!_active) {
+    return 0;
+  }
+  auto usable = std::min(_budget, _backlog);
+  if (_kind != Kind::CBS) {
+    usable = std::min(usable, _deadline - _t);
+  }
+  return usable + debt();
+}
+
+void ServerTask::execute(time_t dt) {
+  /* Serves pending jobs in FIFO order out of the budget.
+   */
+  auto work = pay(static_cast<time_t>(std::floor(dt * speedOn(*_processor))));
+  while (work > 0 && _budget > 0 && !_queue.empty()) {
+    auto &job = _queue.front();
+    auto served = std::min({work, _budget, job.remaining});
+    job.remaining -= served;
+    _backlog -= served;
+    _budget -= served;
+    _consumed += served;
+    work -= served;
+    if (job.remaining == 0) {
+      _responses.add(_t + dt - job.arrival);
+      _queue.pop();
+    }
+  }
+  _status = Status::RUNNING;
+}
+
+void ServerTask::advance(time_t dt) {
+  _t += dt;
+  refill();
+
+  if (_kind == Kind::CBS && !retired() && _attrs.Lt < 0) {
+    throw std::out_of_range("Task deadline miss!");
+  }
+}
+
+void ServerTask::pack(Kernels::Batch &batch, std::size_t i) const {
+  /* Servers have no periodic releases. Only CBS guarantees its
+     deadlines, the others just lose budget when they run late.
+   */
+  auto Ct = _kind == Kind::CBS ? span() : 0;
+  batch.pack(i, Ct, _attrs.Dt, _params.D, _t,
+             std::numeric_limits<time_t>::max());
+}
+
+void ServerTask::unpack(const Kernels::Batch &batch, std::size_t i,
+                        bool /*released*/) {
+  _t = batch.slot(i).t;
+  refill();
+}
+
+void ServerTask::ResponseTimes::add(time_t response) {
+  auto bucket = std::min<std::size_t>(response / width, buckets.size() - 1);
+  buckets[bucket] += 1;
+  count += 1;
+  sum += response;
+  max = std::max(max, response);
+}
+
+time_t ServerTask::ResponseTimes::percentile(double p) const {
+  /* Upper bound of the bucket holding the p-th fraction of jobs.
+   */
+  long seen = 0;
+  for (std::size_t k = 0; k + 1 < buckets.size(); k++) {
+    seen += buckets[k];
+    if (seen > 0 && seen >= p * count) {
+      return std::min<time_t>((k + 1) * width, max);
+    }
+  }
+  return max;
+}
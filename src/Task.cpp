@@ -1,12 +1,21 @@
 #include <Task.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
-Task::Task(Parameters params)
+Task::Task(Parameters params) : Task(params, false) {}
+
+Task::Task(Parameters params, bool parallel)
     : Resource(++_idCount), _params(params), _attrs(params) {
-  /* Initializes a task and validates its utilization.
+  /* Initializes a task and validates its utilization
+     and criticality budgets. Parallel tasks may exceed a
+     single processor; only their critical path is bounded.
    */
-  assert(_params.U <= 1.0);
+  assert(parallel || _params.U <= 1.0);
+  assert(parallel || (_params.C <= _params.CH && _params.CH <= _params.D));
+  assert(_params.CP <= _params.D);
+  assert(_params.A <= (_params.L > 0 ? _params.CH : _params.C));
   reset();
 }
 
@@ -15,6 +24,24 @@ Task::Task(Task &&source) {
   _params = source._params;
   _attrs = source._attrs;
   _status = source._status;
+  _speeds = std::move(source._speeds);
+  _residue = source._residue;
+  _sections = std::move(source._sections);
+  _section = source._section;
+  _held = source._held;
+  _spinning = source._spinning;
+  _suspended = source._suspended;
+  _demand = source._demand;
+  _overran = source._overran;
+  _debt = source._debt;
+  _overheads = source._overheads;
+  _ranOn = std::move(source._ranOn);
+  _switchedOn = std::move(source._switchedOn);
+  _ranUntil = source._ranUntil;
+  _retiring = source._retiring;
+  _retired = source._retired;
+  _slot = source._slot;
+  _polled = source._polled;
   _t = source._t;
 
   if (source.hasProcessor()) {
@@ -33,6 +60,24 @@ Task &Task::operator=(Task &&source) {
   _params = source._params;
   _attrs = source._attrs;
   _status = source._status;
+  _speeds = std::move(source._speeds);
+  _residue = source._residue;
+  _sections = std::move(source._sections);
+  _section = source._section;
+  _held = source._held;
+  _spinning = source._spinning;
+  _suspended = source._suspended;
+  _demand = source._demand;
+  _overran = source._overran;
+  _debt = source._debt;
+  _overheads = source._overheads;
+  _ranOn = std::move(source._ranOn);
+  _switchedOn = std::move(source._switchedOn);
+  _ranUntil = source._ranUntil;
+  _retiring = source._retiring;
+  _retired = source._retired;
+  _slot = source._slot;
+  _polled = source._polled;
   _t = source._t;
 
   if (source.hasProcessor()) {
@@ -48,6 +93,24 @@ void Task::invalidate() {
   _params = Parameters();
   _attrs = Attributes();
   _status = Status::IDLE;
+  _speeds.clear();
+  _residue = 0;
+  _sections.clear();
+  _section = 0;
+  _held = -1;
+  _spinning = false;
+  _suspended = false;
+  _demand = 0;
+  _overran = false;
+  _debt = 0;
+  _overheads = OverheadStats();
+  _ranOn.clear();
+  _switchedOn.clear();
+  _ranUntil = -1;
+  _retiring = false;
+  _retired = false;
+  _slot = -1;
+  _polled = false;
 
   _t = 0;
 }
@@ -56,19 +119,35 @@ void Task::update(bool reload) {
   if (reload) {
     _attrs.Ct = _params.C;
     _attrs.Dt = _params.D;
+    _demand = _params.C;
+    _overran = false;
+    _debt = 0;
   }
 
-  _attrs.Lt = _attrs.Dt - _attrs.Ct;
+  _attrs.Lt = _attrs.Dt - span();
   _attrs.Rt = _params.D - _attrs.Lt;
 }
 
 void Task::reset(bool start) {
   if (start) {
-    _t = 0;
+    // The first job is released at the offset, the time the task joins
+    _t = _params.O;
     _attrs.releases = 1;
+    _retiring = false;
+    _retired = false;
+    _overheads = OverheadStats();
+    _switchedOn.clear();
+    _ranUntil = -1;
   }
 
+  // A new job is switched in, wherever the last one ran
+  _ranOn.clear();
   _status = Status::IDLE;
+  _residue = 0;
+  _section = 0;
+  _held = -1;
+  _spinning = false;
+  _suspended = false;
   update();
 }
 
@@ -86,23 +165,235 @@ void Task::dispatch(time_t dt) {
       throw std::out_of_range("Task execution overrun!");
     }
 
-    _attrs.Ct -= dt;
-    _status = _attrs.Ct > 0 ? Status::RUNNING : Status::COMPLETED;
+    execute(dt);
+    _ranOn.swap(_switchedOn);
+    _switchedOn.clear();
+    _ranUntil = _t + dt;
   }
 
+  advance(dt);
+}
+
+void Task::advance(time_t dt) {
+  /* Moves the task's clock past a step, checking its deadline
+     and releasing its next job when due.
+   */
   _t += dt;
   _attrs.Dt -= dt;
   update(false);
 
-  if (_attrs.Lt < 0) {
+  if (_attrs.Lt < 0 && span() > 0) {
     assert(_attrs.Rt > _params.D);
     throw std::out_of_range("Task deadline miss!");
   }
 
   auto next_r = _params.O + (_attrs.releases * _params.T);
   if (_t >= next_r) {
-    _attrs.releases += 1;
-    reset(false);
+    nextJob();
+  }
+}
+
+void Task::nextJob() {
+  /* Releases the next job, unless the task is retiring:
+     it then leaves at this job boundary instead.
+   */
+  if (expire()) {
+    return;
+  }
+  _attrs.releases += 1;
+  reset(false);
+}
+
+bool Task::expire() {
+  /* Retires the task if it is retiring, at a boundary chosen by the
+     caller. Returns whether it is retired.
+   */
+  if (_retiring) {
+    _retired = true;
+    _status = Status::COMPLETED;
+  }
+  return _retired;
+}
+
+double Task::speedOn(const Processor &processor) const {
+  /* Returns the task's speed on the processor: its own entry
+     when a per-processor table is set, else the processor's speed.
+     Both scale with the processor's current frequency.
+   */
+  if (_speeds.empty()) {
+    return processor.speed();
+  }
+  return _speeds[processor.id() - 1] * processor.frequency();
+}
+
+void Task::execute(time_t dt) {
+  // Work is consumed at the speed of the assigned processor,
+  // rounded down to whole units with the remainder carried over.
+  // A job spinning on a lock holds its processor without progress
+  double work = (_spinning ? 0 : dt * speedOn(*_processor)) + _residue;
+  auto consumed = static_cast<time_t>(std::floor(work));
+  _residue = work - consumed;
+
+  // Locks are taken and released between steps: the job stops at the
+  // start of a section it does not hold, or at the end of the one it
+  // holds, and waits there for the rest of the step
+  auto section = pendingSection();
+  if (section != nullptr) {
+    auto until = section->start + (_held >= 0 ? section->length : 0);
+    auto room = _debt + std::max<time_t>(until - executed(), 0);
+    if (consumed > room) {
+      consumed = room;
+      _residue = 0;
+    }
+  }
+
+  auto excess = std::max<time_t>(consumed - _attrs.Ct, 0);
+  _attrs.Ct = std::max<time_t>(_attrs.Ct - consumed, 0);
+  pay(consumed); // Overheads charged to the job run first
+  if (_attrs.Ct == 0 && _demand < _params.A) {
+    // Overran the LO budget, carry on up to the actual demand with
+    // the work of this step left past the budget
+    _attrs.Ct = std::max<time_t>(_params.A - _demand - excess, 0);
+    _demand = _params.A;
+    _overran = true;
+  } else if (_params.A < _demand && executed() >= _params.A) {
+    // Done early, the rest of the budget goes unused
+    _attrs.Ct = _debt;
+    _demand = _params.A;
+  }
+  _status = _attrs.Ct > 0 ? Status::RUNNING : Status::COMPLETED;
+}
+
+bool Task::switchIn(const Processor &processor, const Overheads &overheads,
+                    time_t scheduling) {
+  /* Charges the overheads of running on the processor for a step.
+     A job that ran on it through the previous step just continues.
+     Otherwise the scheduler switches it in, and a job resuming after
+     a preemption also reloads its cache, at a higher cost when it
+     migrated from another processor. The scheduling cost is charged
+     along with the switch. Returns whether the job was switched in.
+   */
+  auto ran = std::find(_ranOn.begin(), _ranOn.end(), processor.id()) !=
+             _ranOn.end();
+  _switchedOn.emplace_back(processor.id());
+
+  time_t cost = overheads.tick;
+  _overheads.tick += overheads.tick;
+  auto switching = !ran || _ranUntil != _t;
+  if (switching) {
+    _overheads.switches += 1;
+    _overheads.contextSwitch += overheads.contextSwitch + scheduling;
+    cost += overheads.contextSwitch + scheduling;
+
+    if (executed() > 0) {
+      auto cpmd = ran ? overheads.preemption : overheads.migration;
+      _overheads.preemptions += ran ? 1 : 0;
+      _overheads.migrations += ran ? 0 : 1;
+      _overheads.cpmd += cpmd;
+      cost += cpmd;
+    }
+  }
+  charge(cost);
+  return switching;
+}
+
+void Task::chargeRelease(const Overheads &overheads) {
+  _overheads.release += overheads.release;
+  charge(overheads.release);
+}
+
+void Task::charge(time_t cost) {
+  /* Adds overhead to the pending execution of the current job.
+   */
+  if (cost == 0) {
+    return;
+  }
+  _attrs.Ct += cost;
+  _debt += cost;
+  update(false);
+}
+
+time_t Task::pay(time_t work) {
+  /* Spends work on outstanding overhead first, returning the rest.
+   */
+  auto paid = std::min(work, _debt);
+  _debt -= paid;
+  return work - paid;
+}
+
+void Task::setSections(std::vector<CriticalSection> sections) {
+  /* Sets the critical sections executed by every job of the task.
+   */
+  std::sort(sections.begin(), sections.end(),
+            [](const CriticalSection &a, const CriticalSection &b) {
+              return a.start < b.start;
+            });
+  for (int i = 0; i < sections.size(); i++) {
+    const auto &section = sections[i];
+    // Jobs complete after A, the sections must be done by then
+    assert(section.start + section.length <= std::min(_params.C, _params.A));
+    assert(i == 0 || sections[i - 1].start + sections[i - 1].length <=
+                         section.start);
+  }
+  _sections = std::move(sections);
+}
+
+const Task::CriticalSection *Task::pendingSection() const {
+  /* Returns the next (or held) section of the current job, if any.
+   */
+  if (_section >= _sections.size()) {
+    return nullptr;
+  }
+  return &_sections[_section];
+}
+
+void Task::lock(int resource) {
+  _held = resource;
+  _spinning = false;
+  _suspended = false;
+}
+
+void Task::unlock() {
+  _held = -1;
+  _section += 1;
+}
+
+void Task::skip() {
+  /* Abandons the current job; the task waits for its next release.
+   */
+  _attrs.Ct = 0;
+  _debt = 0;
+  _status = Status::COMPLETED;
+  update(false);
+}
+
+void Task::pack(Kernels::Batch &batch, std::size_t i) const {
+  /* Writes the time attributes into slot i of a packed batch.
+   */
+  batch.pack(i, span(), _attrs.Dt, _params.D, _t,
+             _params.O + (_attrs.releases * _params.T));
+}
+
+void Task::unpack(const Kernels::Batch &batch, std::size_t i, bool released) {
+  /* Reads back slot i of a batch stepped by Kernels::advance,
+     completing what dispatch() does for a task without a processor.
+   */
+  restore(batch, i);
+  if (released) {
+    nextJob();
+  }
+}
+
+void Task::restore(const Kernels::Batch &batch, std::size_t i) {
+  /* Reads the stepped times of slot i back into the task.
+   */
+  auto slot = batch.slot(i);
+  _t = slot.t;
+  _attrs.Dt = slot.Dt;
+  _attrs.Lt = slot.Lt;
+  _attrs.Rt = slot.Rt;
+  if (_status == Status::RUNNING && _ranUntil < _t) {
+    _status = Status::IDLE; // Idled since it last ran
   }
 }
 
@@ -2,20 +2,48 @@
 #include <cassert>
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <numeric>
-#include <set>
+#include <map>
 #include <utils.hpp>
 
 // Init static variables
 int Task::_idCount = 0;
 int Processor::_idCount = 0;
 
-TaskSystem::TaskSystem(int m, bool log) : _m(m) {
-  /* Initializes the task system with the set number of processors.
+TaskSystem::TaskSystem(int m, bool log, std::pmr::memory_resource *upstream)
+    : TaskSystem(std::vector<double>(m, 1.0), log, upstream) {
+  /* Initializes the task system with the set number of unit-speed
+     (identical) processors.
    */
-  for (int i = 0; i < m; i++) {
-    _processors.emplace_back(std::make_unique<Processor>());
+}
+
+TaskSystem::TaskSystem(std::vector<double> speeds, bool log,
+                       std::pmr::memory_resource *upstream)
+    : _m(speeds.size()), _upstream(upstream),
+      _arena(std::make_unique<std::pmr::monotonic_buffer_resource>(upstream)),
+      _pool(std::make_unique<std::pmr::unsynchronized_pool_resource>(
+          _arena.get())) {
+  /* Initializes the task system with one processor per given speed
+     (uniform platform).
+     Tasks are allocated from a per-system arena drawn from upstream,
+     through a pool that reuses the storage of retired tasks.
+   */
+  _capacity = 0;
+  for (auto speed : speeds) {
+    _processors.emplace_back(std::make_unique<Processor>(speed));
+    _capacity += speed;
+  }
+
+  // GFB on uniform platforms: lambda = max_j sum_{i > j} s_i / s_j,
+  // over speeds in decreasing order
+  std::sort(speeds.rbegin(), speeds.rend());
+  double slower = 0;
+  for (int j = speeds.size() - 1; j >= 0; j--) {
+    _lambda = std::max(_lambda, slower / speeds[j]);
+    slower += speeds[j];
   }
+  _identical = speeds.empty() || speeds.front() == speeds.back();
 
   if (log) {
     _display = std::make_shared<Display>(_m);
@@ -29,17 +57,54 @@ TaskSystem::TaskSystem(TaskSystem &&source) {
   _m = source._m;
   _n = source._n;
   _util = source._util;
+  _capacity = source._capacity;
+  _lambda = source._lambda;
+  _identical = source._identical;
 
   _t = source._t;
   _quantumSize = source._quantumSize;
   _hyperperiod = source._hyperperiod;
+  _energy = source._energy;
+  _peakPower = source._peakPower;
+  _mode = source._mode;
+  _switching = source._switching;
+  _degradation = source._degradation;
+  _modeSwitches = source._modeSwitches;
+  _lostJobs = source._lostJobs;
+  _lostWork = source._lostWork;
+  _overheads = source._overheads;
+  _density = source._density;
+  _densities = std::move(source._densities);
+  _utils = std::move(source._utils);
+  _windows = std::move(source._windows);
+  _granules = std::move(source._granules);
+  _periods = std::move(source._periods);
+  _admission = source._admission;
+  _compactTime = source._compactTime;
+  _compact = source._compact;
+  _widened = source._widened;
 
   _display = std::move(source._display);
+  _recorder = std::move(source._recorder);
+  _running = std::move(source._running);
 
+  // Tasks go first so any held ones are released into their own arena
   _readyTasks = std::move(source._readyTasks);
   _dispatchedTasks = std::move(source._dispatchedTasks);
   _completedTasks = std::move(source._completedTasks);
+  _blockedTasks = std::move(source._blockedTasks);
+  _arrivals = std::move(source._arrivals);
+  _arriving = std::move(source._arriving);
+  _index = std::move(source._index);
+  _locks = std::move(source._locks);
+  _holders = std::move(source._holders);
+  _batch = std::move(source._batch);
+  _slots = std::move(source._slots);
+  _polled = std::move(source._polled);
   _processors = std::move(source._processors);
+  _upstream = source._upstream;
+  _arena = std::move(source._arena);
+  _pool = std::move(source._pool);
 
   source.invalidate();
 }
@@ -52,17 +117,55 @@ TaskSystem &TaskSystem::operator=(TaskSystem &&source) {
   _m = source._m;
   _n = source._n;
   _util = source._util;
+  _capacity = source._capacity;
+  _lambda = source._lambda;
+  _identical = source._identical;
 
   _t = source._t;
   _quantumSize = source._quantumSize;
   _hyperperiod = source._hyperperiod;
+  _energy = source._energy;
+  _peakPower = source._peakPower;
+  _mode = source._mode;
+  _switching = source._switching;
+  _degradation = source._degradation;
+  _modeSwitches = source._modeSwitches;
+  _lostJobs = source._lostJobs;
+  _lostWork = source._lostWork;
+  _overheads = source._overheads;
+  _density = source._density;
+  _densities = std::move(source._densities);
+  _utils = std::move(source._utils);
+  _windows = std::move(source._windows);
+  _granules = std::move(source._granules);
+  _periods = std::move(source._periods);
+  _admission = source._admission;
+  _compactTime = source._compactTime;
+  _compact = source._compact;
+  _widened = source._widened;
 
   _display = std::move(source._display);
+  _recorder = std::move(source._recorder);
+  _running = std::move(source._running);
 
+  // Tasks go first so any held ones are released into their own arena
   _readyTasks = std::move(source._readyTasks);
   _dispatchedTasks = std::move(source._dispatchedTasks);
   _completedTasks = std::move(source._completedTasks);
+  _blockedTasks = std::move(source._blockedTasks);
+  _arrivals = std::move(source._arrivals);
+  _arriving = std::move(source._arriving);
+  _index = std::move(source._index);
+  _locks = std::move(source._locks);
+  _holders = std::move(source._holders);
+  _batch = std::move(source._batch);
+  _slots = std::move(source._slots);
+  _polled = std::move(source._polled);
   _processors = std::move(source._processors);
+  _upstream = source._upstream;
+  // The old pool hands its storage back to the old arena on the way out
+  _pool = std::move(source._pool);
+  _arena = std::move(source._arena);
 
   source.invalidate();
   return *this;
@@ -70,22 +173,140 @@ TaskSystem &TaskSystem::operator=(TaskSystem &&source) {
 
 void TaskSystem::invalidate() {
   _m = 1;
+  _n = 0;
   _util = 0;
+  _capacity = 1;
+  _lambda = 0;
+  _identical = true;
   _quantumSize = 0;
   _hyperperiod = 1;
+  _density = 0;
+  _densities.clear();
+  _utils.clear();
+  _windows.clear();
+  _granules.clear();
+  _periods.clear();
+  _batch = Kernels::Batch();
+  _slots.clear();
+  _polled.clear();
+  _arena = std::make_unique<std::pmr::monotonic_buffer_resource>(_upstream);
+  _pool =
+      std::make_unique<std::pmr::unsynchronized_pool_resource>(_arena.get());
 }
 
-TaskState TaskSystem::getState(const TaskSubSet &tasks) {
+const TaskState &TaskSystem::getState(const TaskSubSet &tasks,
+                                      TaskState &state,
+                                      std::vector<int> *holders) {
   /* Packs tuples of (id, parameters, attributes) of tasks.
+     Reuses the given state buffer to avoid reallocating every step.
+     Optionally notes the indices of lock holders on the way.
    */
-  TaskState state;
+  state.clear();
+  state.reserve(tasks.size());
+  if (holders != nullptr) {
+    holders->clear();
+  }
+
   for (int i = 0; i < tasks.size(); i++) {
     const auto &task = tasks[i];
-    state.emplace_back(task->id(), task->params(), task->attrs());
+    auto &attrs = std::get<2>(
+        state.emplace_back(task->id(), task->params(), task->attrs()));
+    if (task->slot() >= 0 && !task->polled()) {
+      // Times come from the batch, the task is synced when it runs
+      auto slot = _batch.slot(task->slot());
+      attrs.Dt = slot.Dt;
+      attrs.Lt = slot.Lt;
+      attrs.Rt = slot.Rt;
+    }
+    if (holders != nullptr && task->held() >= 0) {
+      holders->emplace_back(i);
+    }
   }
   return state;
 }
 
+const std::vector<int> &
+TaskSystem::acquireLocks(const std::vector<int> &indices) {
+  /* Applies the locking protocol to the scheduler's selection.
+     Boosted lock holders run first, then selected jobs reaching a
+     critical section request its resource. Jobs that must suspend
+     (or may not start, under SRP) are left out of this step, and
+     moved to the blocked tasks after it.
+   */
+  if (_locks.empty()) {
+    return indices;
+  }
+
+  _selected.clear();
+  for (auto i : _holders) {
+    if (i < _readyTasks.size() && _locks.boosted(*_readyTasks[i])) {
+      _selected.emplace_back(i);
+    }
+  }
+  auto boosted = _selected.size();
+  for (auto i : indices) {
+    if (i < 0 || i >= _readyTasks.size()) {
+      throw std::out_of_range("At least one job is out of index!");
+    }
+    // Repeated indices of parallel tasks are kept
+    if (std::find(_selected.begin(), _selected.begin() + boosted, i) ==
+        _selected.begin() + boosted) {
+      _selected.emplace_back(i);
+    }
+  }
+  if (_selected.size() > _m) {
+    _selected.resize(_m);
+  }
+
+  _selected.erase(
+      std::remove_if(_selected.begin(), _selected.end(),
+                     [this](const int &i) {
+                       auto task = _readyTasks[i].get();
+                       if (task->held() >= 0 || task->spinning()) {
+                         return false;
+                       }
+                       if (task->executed() == 0 && !_locks.admit(task, _t)) {
+                         _moved = true;
+                         return true;
+                       }
+
+                       auto section = task->pendingSection();
+                       if (section == nullptr ||
+                           task->executed() < section->start) {
+                         return false;
+                       }
+                       if (_locks.request(task, _t) ==
+                           LockManager::Outcome::SUSPEND) {
+                         _moved = true;
+                         return true;
+                       }
+                       return false;
+                     }),
+      _selected.end());
+
+  return _selected;
+}
+
+void TaskSystem::releaseLocks(Task *task, time_t dt) {
+  /* Accounts spinning and releases a resource whose critical
+     section the task has completed in this step. Jobs it wakes
+     move back to the ready tasks after the step.
+   */
+  if (task->spinning()) {
+    _locks.spun(*task, dt);
+    return;
+  }
+  if (task->held() < 0) {
+    return;
+  }
+
+  auto section = task->pendingSection();
+  if (task->executed() >= section->start + section->length &&
+      _locks.release(task, _t + dt)) {
+    _moved = true;
+  }
+}
+
 void TaskSystem::dispatchTasks(const std::vector<int> &indices, time_t dt) {
   /* Runs validations for selected task indices
     to check for potential timing faults.
@@ -101,28 +322,77 @@ void TaskSystem::dispatchTasks(const std::vector<int> &indices, time_t dt) {
     throw std::out_of_range("More jobs than the available processors!");
   }
 
-  std::set<int> uniqueIndices(indices.begin(), indices.end());
-  if (uniqueIndices.size() < indices.size()) {
-    throw std::out_of_range("Jobs are not unique!");
+  std::map<int, int> slots;
+  for (auto i : indices) {
+    slots[i] += 1;
   }
-
-  auto maxIndex = *std::max_element(indices.begin(), indices.end());
-  if (maxIndex >= _readyTasks.size()) {
+  if (slots.rbegin()->first >= _readyTasks.size()) {
     throw std::out_of_range("At least one job is out of index!");
   }
+  for (const auto &[i, count] : slots) {
+    // Parallel jobs may take one processor per ready node
+    if (count > std::max(_readyTasks[i]->attrs().Nt, 1)) {
+      throw std::out_of_range("Jobs are not unique!");
+    }
+  }
 
+  // Indices come in priority order, so each task (or node of a
+  // parallel task) in turn takes the fastest free processor for it.
+  // Overheads are charged as jobs are switched in, the scheduler's
+  // once a step to the first of them
+  auto scheduling =
+      _overheads.scheduler + (_overheads.schedulerPerTask * _readyTasks.size());
+  std::vector<Task *> owners(indices.size());
+  std::vector<int> procIndices(indices.size());
   for (int k = 0; k < indices.size(); k++) {
     const auto &i = indices[k];
-    auto &processor = _processors[k];
-    auto procIdx = processor->id() - 1;
-    auto &task = _dispatchedTasks.emplace_back(std::move(_readyTasks[i]));
-    task->allocateProcessor(std::move(processor));
+    if (_readyTasks[i] != nullptr) {
+      auto &task = _dispatchedTasks.emplace_back(std::move(_readyTasks[i]));
+      owners[k] = task.get();
+      sync(*task);
+    } else {
+      auto first = std::find(indices.begin(), indices.begin() + k, i);
+      owners[k] = owners[first - indices.begin()];
+    }
+
+    auto &processor = fastestProcessor(*owners[k]);
+    procIndices[k] = processor->id() - 1;
+    _power += processor->power(true);
+    if (owners[k]->switchIn(*processor, _overheads, scheduling)) {
+      scheduling = 0;
+    }
+    owners[k]->allocateProcessor(std::move(processor));
+  }
+
+  for (int k = 0; k < indices.size(); k++) {
+    auto task = owners[k];
+    if (std::find(owners.begin(), owners.begin() + k, task) !=
+        owners.begin() + k) {
+      continue; // Already stepped with all its processors
+    }
+
+    auto releases = task->attrs().releases;
     task->dispatch(dt);
+    releaseLocks(task, dt);
+    if (_mode == 0 && task->overran()) {
+      _switching = true;
+    }
+    if (task->attrs().releases != releases) {
+      released(*task);
+    }
+  }
+
+  if (_recorder != nullptr) {
+    for (int k = 0; k < indices.size(); k++) {
+      _running[procIndices[k]] = owners[k]->id();
+    }
+  }
 
-    if (_display != nullptr) {
-      _display->updateTrace(procIdx, task->id());
-      _display->updateList(Display::ListingType::RUNNING, procIdx, task->id(),
-                           task->toString());
+  if (_display != nullptr) {
+    for (int k = 0; k < indices.size(); k++) {
+      _display->updateTrace(procIndices[k], owners[k]->id());
+      _display->updateList(Display::ListingType::RUNNING, procIndices[k],
+                           owners[k]->id(), owners[k]->toString());
     }
   }
 
@@ -130,57 +400,493 @@ void TaskSystem::dispatchTasks(const std::vector<int> &indices, time_t dt) {
   refresh(_readyTasks);
 }
 
-void TaskSystem::dispatchTasks(TaskSubSet &tasks, time_t dt) {
-  /* Idles tasks without processors.
+ProcessorPtr &TaskSystem::fastestProcessor(const Task &task) {
+  /* Picks the free processor the task runs fastest on,
+     the first one among equals.
    */
+  ProcessorPtr *fastest = nullptr;
+  for (auto &processor : _processors) {
+    if (processor == nullptr) {
+      continue;
+    }
+    if (fastest == nullptr ||
+        task.speedOn(*processor) > task.speedOn(**fastest)) {
+      fastest = &processor;
+    }
+  }
+  return *fastest;
+}
 
-  int readyCount = 0;
-  for (auto &task : tasks) {
-    task->dispatch(dt);
-    auto &_task = _dispatchedTasks.emplace_back(std::move(task));
+void TaskSystem::idleTasks(time_t dt) {
+  /* Steps the tasks without processors (ready, completed and blocked)
+     together over the batch, which holds their times between steps.
+     Only tasks that ran, are released or are polled are written back
+     to the batch; the others read their times back when looked at.
+   */
+  auto scale = _compact ? _quantumSize : 0;
+  if (scale != _batch.quantum ||
+      (_batch.compact() &&
+       (_t - _batch.base) / _batch.quantum > Kernels::maxQuanta / 2)) {
+    _batch.setScale(scale, _t);
+  }
+  for (auto task : _polled) {
+    if (!task->hasProcessor()) {
+      store(*task);
+    }
+  }
+
+  Kernels::advance(_batch, dt, _misses, _releases);
+  if (_compact && !_batch.compact()) {
+    _compact = false; // Fell back, keep to 64 bits until a reset
+    _widened = true;
+  }
+
+  // Tasks that ran stepped themselves
+  for (auto &task : _dispatchedTasks) {
+    store(*task);
+    Kernels::clear(_misses, task->slot());
+    Kernels::clear(_releases, task->slot());
+  }
+  if (Kernels::any(_misses)) {
+    throw std::out_of_range("Task deadline miss!");
+  }
 
-    if (_display == nullptr) {
+  for (auto task : _polled) {
+    if (!task->hasProcessor()) {
+      auto ready = task->ready();
+      task->unpack(_batch, task->slot(), false);
+      store(*task);
+      _moved = _moved || task->ready() != ready || task->retired();
+    }
+  }
+  for (std::size_t w = 0; w < _releases.size(); w++) {
+    for (auto word = _releases[w]; word != 0; word &= word - 1) {
+      auto task = _slots[(w << 6) + __builtin_ctzll(word)];
+      auto ready = task->ready();
+      task->unpack(_batch, task->slot(), true);
+      if (!task->retired()) {
+        released(*task);
+      }
+      store(*task);
+      _moved = _moved || task->ready() != ready || task->retired();
+    }
+  }
+
+  if (_display == nullptr) {
+    return;
+  }
+  int row = 0;
+  for (auto subset : {&_readyTasks, &_completedTasks, &_blockedTasks}) {
+    for (auto &task : *subset) {
+      sync(*task);
+      if (task->status() == Task::Status::IDLE) {
+        _display->updateList(Display::ListingType::IDLE, row++, task->id(),
+                             task->toString());
+      }
+    }
+  }
+}
+
+void TaskSystem::reclassify(bool switching) {
+  /* Sorts the tasks into ready, completed and blocked after a step:
+     those that ran first, then the idle ones in their previous order.
+     Unless an idle task changed subset, the ones that ran are just put
+     in front. On a mode switch pending LO jobs are dropped on the way.
+   */
+  for (auto &task : _dispatchedTasks) {
+    if (!task->stepped(_t)) {
       continue;
     }
-    if (_task->status() == Task::Status::IDLE) {
-      _display->updateList(Display::ListingType::IDLE, readyCount++,
-                           _task->id(), task->toString());
+    acquireResources(task);
+    route(task, switching);
+  }
+  refresh(_dispatchedTasks);
+
+  if (!_moved && !switching) {
+    for (auto [tasks, ran] : {std::make_pair(&_readyTasks, &_nextReady),
+                              std::make_pair(&_completedTasks, &_nextCompleted),
+                              std::make_pair(&_blockedTasks, &_nextBlocked)}) {
+      tasks->insert(tasks->begin(), std::make_move_iterator(ran->begin()),
+                    std::make_move_iterator(ran->end()));
+      ran->clear();
+    }
+    return;
+  }
+
+  for (auto subset : {&_readyTasks, &_completedTasks, &_blockedTasks}) {
+    for (auto &task : *subset) {
+      route(task, switching);
     }
+    subset->clear();
   }
-  tasks.clear();
+  _readyTasks.swap(_nextReady);
+  _completedTasks.swap(_nextCompleted);
+  _blockedTasks.swap(_nextBlocked);
+}
+
+void TaskSystem::route(TaskPtr &task, bool switching) {
+  /* Moves a stepped task to the subset its state calls for,
+     destroying it once retired.
+   */
+  if (switching && task->params().L < _mode) {
+    sync(*task);
+    dropJob(*task);
+    store(*task);
+  }
+  if (task->retired()) {
+    leave(*task);
+    task.reset(); // Storage goes back to the pool
+  } else if (task->suspended()) {
+    _nextBlocked.emplace_back(std::move(task));
+  } else if (task->ready()) {
+    _nextReady.emplace_back(std::move(task));
+  } else {
+    _nextCompleted.emplace_back(std::move(task));
+  }
+}
+
+void TaskSystem::released(Task &task) {
+  /* Handles a new job release: in HI mode, LO jobs are dropped
+     (or thinned out when degrading). Jobs kept pay the release
+     overhead.
+   */
+  if (_mode > 0 && task.params().L < _mode &&
+      (_degradation == 0 || task.attrs().releases % _degradation != 0)) {
+    dropJob(task);
+  }
+  if (task.ready()) {
+    task.chargeRelease(_overheads);
+  }
+}
+
+void TaskSystem::dropJob(Task &task) {
+  /* Abandons a pending job, counting the lost service.
+     Jobs inside or waiting for a critical section run on.
+   */
+  if (!task.ready() || task.held() >= 0 || task.spinning() ||
+      task.suspended()) {
+    return;
+  }
+  _lostJobs += 1;
+  _lostWork += task.attrs().Ct - task.debt(); // Overheads were not work
+  task.skip();
 }
 
 void TaskSystem::acquireResources(TaskPtr &task) {
   /* Releases processors from tasks to the pool.
    */
-  if (task->hasProcessor()) {
+  while (task->hasProcessor()) {
     _processors.emplace_back(task->releaseProcessor());
   }
 }
 
-void TaskSystem::addTask(Task::Parameters params) {
+int TaskSystem::addTask(Task::Parameters params,
+                        std::vector<Task::CriticalSection> sections,
+                        std::vector<double> speeds) {
   /* Creates a new task and validates its utilization.
      Recomputes the system's timing attributes
      and adds the task to ready.
+     Critical sections register the task with their resources;
+     optional per-processor speeds model unrelated platforms.
+     Returns the task's id.
    */
 
-  auto task = std::make_unique<Task>(params);
-  if (task->util() == 0) {
-    return;
+  if (params.U == 0) {
+    return 0;
+  }
+  params.O = std::max(params.O, _t); // Joins now at the earliest
+  reserve(params.U);
+  auto task = makeArena<Task>(_pool.get(), params);
+  if (!speeds.empty()) {
+    assert(speeds.size() == _m);
+    task->setSpeeds(std::move(speeds));
+  }
+
+  for (const auto &section : sections) {
+    _locks.use(section.resource, params.D);
+  }
+  task->setSections(std::move(sections));
+
+  return join(std::move(task));
+}
+
+int TaskSystem::addDagTask(time_t T, time_t D,
+                           std::vector<DagTask::Node> nodes) {
+  /* Creates a DAG (parallel) task and adds it to ready.
+     Node WCETs join the quantum so that nodes complete on
+     quantum boundaries.
+   */
+  auto task = makeArena<DagTask>(_pool.get(), T, D, std::move(nodes), _t);
+  reserve(task->util());
+  return join(std::move(task));
+}
+
+int TaskSystem::addServer(ServerTask::Kind kind, time_t Q, time_t T,
+                          std::unique_ptr<ArrivalStream> arrivals) {
+  /* Creates a reservation server with budget Q every period T,
+     serving the given stream of aperiodic jobs, and adds it to ready.
+   */
+  auto task = makeArena<ServerTask>(_pool.get(), kind, Q, T,
+                                    std::move(arrivals), _t);
+  reserve(task->util());
+  return join(std::move(task));
+}
+
+int TaskSystem::admitTask(Task::Parameters params,
+                          std::vector<Task::CriticalSection> sections,
+                          std::vector<double> speeds) {
+  /* Admits a task while the system runs. It joins at the current
+     time, or at its offset if later, when it passes the admission
+     test. Returns its id, or 0 if rejected.
+   */
+  params.O = std::max(params.O, _t);
+  if (params.U == 0 || !admissible(params)) {
+    return 0;
+  }
+  return addTask(params, std::move(sections), std::move(speeds));
+}
+
+bool TaskSystem::admissible(const Task::Parameters &params) const {
+  /* Admission test in O(log n), over sums kept as tasks come and go:
+     - UTILIZATION: total utilization within the platform's capacity,
+       exact for pFair on identical processors. On other uniform
+       platforms, the GFB bound for global EDF, U <= S - lambda u_max.
+     - DENSITY: in addition, the same bound over densities, for
+       constrained deadlines (m - (m - 1) max on identical ones).
+   */
+  if (_util + params.U > _capacity) {
+    return false;
+  }
+  if (_admission == Admission::DENSITY) {
+    auto density = static_cast<double>(params.C) / std::min(params.D, params.T);
+    auto maxDensity = _densities.empty()
+                          ? density
+                          : std::max(density, *_densities.rbegin());
+    return _density + density <= _capacity - (_lambda * maxDensity);
+  }
+  if (!_identical) {
+    auto maxUtil =
+        _utils.empty() ? params.U : std::max(params.U, *_utils.rbegin());
+    return _util + params.U <= _capacity - (_lambda * maxUtil);
   }
-  _util += task->util();
-  assert(_util <= _m);
+  return true;
+}
 
-  Task::Parameters p = task->params();
-  std::vector<time_t> v{p.C, p.D, p.T};
-  _quantumSize = std::reduce(v.begin(), v.end(), _quantumSize,
-                             [](const time_t &init, const time_t &first) {
-                               return std::gcd(init, first);
-                             });
-  _hyperperiod = std::lcm(_hyperperiod, p.T);
+void TaskSystem::reserve(double U) const {
+  /* Rejects a task that would overcommit the platform.
+   */
+  if (_util + U > _capacity) {
+    throw std::out_of_range("Task set exceeds the platform capacity!");
+  }
+}
 
-  _readyTasks.emplace_back(std::move(task));
+bool TaskSystem::retireTask(int id) {
+  /* Retires a task at its next job boundary (the end of the current
+     period). Its utilization is reclaimed there without harm to the
+     others; under pFair its lag is zero at that point. A server leaves
+     at its deadline instead, the end of its current period. A task
+     yet to arrive leaves at once. Returns false for an unknown task.
+   */
+  auto found = _index.find(id);
+  if (found == _index.end()) {
+    return false;
+  }
+
+  auto arrival = _arriving.find(id);
+  if (arrival != _arriving.end()) {
+    leave(*arrival->second->second);
+    _arrivals.erase(arrival->second);
+    _arriving.erase(arrival);
+    return true;
+  }
+
+  found->second->retire();
+  return true;
+}
+
+Task *TaskSystem::task(int id) const {
+  auto found = _index.find(id);
+  if (found == _index.end()) {
+    return nullptr;
+  }
+  sync(*found->second);
+  return found->second;
+}
+
+int TaskSystem::join(TaskPtr task) {
+  /* Registers a task with the system's timing attributes, updated
+     incrementally, and adds it to ready (or to the arrivals when
+     it joins later).
+   */
+  const auto &p = task->params();
+  _util += p.U;
+  auto density = static_cast<double>(p.C) / std::min(p.D, p.T);
+  _density += density;
+  _densities.insert(density);
+  _utils.insert(p.U);
+  _windows.insert(std::max(p.D, p.T));
+
+  for (auto v : granules(*task)) {
+    if (v > 0 && _granules[v]++ == 0) {
+      _quantumSize = std::gcd(_quantumSize, v);
+    }
+  }
+  if (_periods[p.T]++ == 0) {
+    _hyperperiod = std::lcm(_hyperperiod, p.T);
+  }
+  normalize();
+
+  auto id = task->id();
+  _index[id] = task.get();
   _n += 1;
+  if (p.O > _t) {
+    defer(std::move(task));
+  } else {
+    enter(std::move(task));
+  }
+  return id;
+}
+
+void TaskSystem::normalize() {
+  /* Chooses how idle tasks are stepped, once the task set is known:
+     as 32-bit counts of quanta when the longest window, max(D, T),
+     is at most half the range, as 64-bit times otherwise. Times are
+     relative to a base rebased every half range, so they stay within
+     it whatever the hyperperiod. Times that turn out not to be whole
+     quanta (e.g. on scaled processors) fall back for good, until a
+     reset.
+   */
+  _compact = _compactTime && !_widened && _quantumSize > 0 &&
+             !_windows.empty() &&
+             *_windows.rbegin() / _quantumSize <= Kernels::maxQuanta / 2;
+}
+
+void TaskSystem::leave(Task &task) {
+  /* Unregisters a retired task. The quantum still divides all
+     remaining times, so it is kept: growing it mid-run could split
+     pending jobs. It is regrown over the distinct times left when the
+     system restarts. The hyperperiod is recomputed only when the
+     task's period was the last of its kind. Resource ceilings are
+     kept, which is safe.
+   */
+  const auto &p = task.params();
+  _util -= p.U;
+  auto density = static_cast<double>(p.C) / std::min(p.D, p.T);
+  _density -= density;
+  _densities.erase(_densities.find(density));
+  _utils.erase(_utils.find(p.U));
+  _windows.erase(_windows.find(std::max(p.D, p.T)));
+
+  for (auto v : granules(task)) {
+    if (v > 0 && --_granules[v] == 0) {
+      _granules.erase(v);
+    }
+  }
+  if (--_periods[p.T] == 0) {
+    _periods.erase(p.T);
+    _hyperperiod = 1;
+    for (const auto &[T, count] : _periods) {
+      _hyperperiod = std::lcm(_hyperperiod, T);
+    }
+  }
+
+  if (task.slot() >= 0) {
+    detach(task);
+  }
+  _index.erase(task.id());
+  _n -= 1;
+  if (_n == 0) {
+    _util = 0;
+    _density = 0;
+  }
+}
+
+std::vector<time_t> TaskSystem::granules(const Task &task) const {
+  /* Lists the times of a task the quantum must divide.
+   */
+  const auto &p = task.params();
+  std::vector<time_t> v{p.C, p.D, p.T, p.O, p.CH, p.A};
+  for (const auto &section : task.sections()) {
+    v.insert(v.end(), {section.start, section.length});
+  }
+  if (auto dag = dynamic_cast<const DagTask *>(&task)) {
+    for (const auto &node : dag->nodes()) {
+      v.emplace_back(node.C);
+    }
+  }
+  return v;
+}
+
+void TaskSystem::defer(TaskPtr task) {
+  /* Queues a task until its offset. Among equal offsets the latest
+     queued joins first.
+   */
+  auto id = task->id();
+  auto O = task->params().O;
+  _arriving[id] =
+      _arrivals.emplace_hint(_arrivals.lower_bound(O), O, std::move(task));
+}
+
+void TaskSystem::arrive() {
+  /* Moves tasks whose offset has come from the arrivals to ready.
+   */
+  while (!_arrivals.empty() && _arrivals.begin()->first <= _t) {
+    auto task = std::move(_arrivals.begin()->second);
+    _arrivals.erase(_arrivals.begin());
+    _arriving.erase(task->id());
+    enter(std::move(task));
+  }
+}
+
+void TaskSystem::enter(TaskPtr task) {
+  /* Adds a joining task to ready, or to completed when it has
+     nothing to run yet (an idle server).
+   */
+  attach(*task);
+  if (task->ready()) {
+    _readyTasks.emplace_back(std::move(task));
+  } else {
+    _completedTasks.emplace_back(std::move(task));
+  }
+}
+
+void TaskSystem::attach(Task &task) {
+  /* Gives an active task the next slot of the batch.
+   */
+  task.setSlot(_slots.size());
+  _slots.emplace_back(&task);
+  _batch.resize(_slots.size());
+  store(task);
+  if (task.polled()) {
+    _polled.emplace_back(&task);
+  }
+}
+
+void TaskSystem::detach(Task &task) {
+  /* Frees the slot of a leaving task, moving the last one into it.
+   */
+  auto i = task.slot();
+  auto last = _slots.size() - 1;
+  if (i != last) {
+    _batch.move(last, i);
+    _slots[i] = _slots[last];
+    _slots[i]->setSlot(i);
+  }
+  _slots.pop_back();
+  _batch.resize(last);
+  task.setSlot(-1);
+  if (task.polled()) {
+    _polled.erase(std::find(_polled.begin(), _polled.end(), &task));
+  }
+}
+
+void TaskSystem::sync(Task &task) const {
+  /* Reads the times of an idle task back from the batch. Polled
+     tasks are kept up to date every step.
+   */
+  if (task.slot() >= 0 && !task.polled()) {
+    task.restore(_batch, task.slot());
+  }
 }
 
 void TaskSystem::loadTasks(std::string filename) {
@@ -190,11 +896,51 @@ void TaskSystem::loadTasks(std::string filename) {
   }
 
   for (auto &task : tasks) {
-    auto [C, T] = task;
-    addTask(Task::Parameters{C, T});
+    if (task.nodes.empty()) {
+      addTask(Task::Parameters{task.C, task.T});
+    } else {
+      addDagTask(task.T, task.D, std::move(task.nodes));
+    }
   }
 
-  _display->updateStatus(toString());
+  if (_display != nullptr) {
+    _display->updateStatus(toString());
+  }
+}
+
+void TaskSystem::setOperatingPoints(std::vector<OperatingPoint> points,
+                                    PowerModel model) {
+  /* Sets the same frequency/voltage points and power model on all
+     processors, starting at the nominal frequency.
+   */
+  for (auto &processor : _processors) {
+    processor->setOperatingPoints(points, model);
+  }
+}
+
+void TaskSystem::setFrequency(double frequency) {
+  /* Scales all processors to the lowest operating point
+     at or above the given fraction of nominal frequency.
+   */
+  for (auto &processor : _processors) {
+    processor->setFrequency(frequency);
+  }
+}
+
+void TaskSystem::setFrequency(int index, double frequency) {
+  processor(index).setFrequency(frequency);
+}
+
+Processor &TaskSystem::processor(int index) {
+  /* Looks up a processor by index (id - 1) in the pool.
+     Between steps all processors are back in the pool.
+   */
+  for (auto &processor : _processors) {
+    if (processor != nullptr && processor->id() - 1 == index) {
+      return *processor;
+    }
+  }
+  throw std::out_of_range("Processor is not available!");
 }
 
 void TaskSystem::reset() {
@@ -202,6 +948,8 @@ void TaskSystem::reset() {
      Returns all tasks to ready and resets them.
   */
   _t = 0;
+  _energy = 0;
+  _peakPower = 0;
 
   for (auto &task : _dispatchedTasks) {
     acquireResources(task);
@@ -212,29 +960,142 @@ void TaskSystem::reset() {
     _readyTasks.emplace_back(std::move(task));
   }
 
+  for (auto &task : _blockedTasks) {
+    _readyTasks.emplace_back(std::move(task));
+  }
+
+  _slots.clear();
+  _polled.clear();
+  _batch.resize(0);
+  _batch.setScale(0, 0);
   for (auto &task : _readyTasks) {
+    task->setSlot(-1);
+    task->reset();
+    if (task->params().O > 0) {
+      defer(std::move(task));
+    } else if (!task->ready()) {
+      _completedTasks.emplace_back(std::move(task));
+    }
+  }
+  for (auto &[O, task] : _arrivals) {
     task->reset();
   }
+  refresh(_readyTasks);
+  if (!_granules.empty()) {
+    _quantumSize = 0;
+    for (const auto &[v, count] : _granules) {
+      _quantumSize = std::gcd(_quantumSize, v);
+    }
+  }
+  _widened = false;
+  normalize();
+  _locks.reset();
+  _holders.clear();
+  _mode = 0;
+  _switching = false;
+  _modeSwitches = 0;
+  _lostJobs = 0;
+  _lostWork = 0;
 
   refresh(_dispatchedTasks);
   refresh(_completedTasks);
+  refresh(_blockedTasks);
+  for (auto subset : {&_readyTasks, &_completedTasks}) {
+    for (auto &task : *subset) {
+      attach(*task);
+    }
+  }
+}
+
+void TaskSystem::clear() {
+  /* Returns any held processors, destroys all tasks
+     and releases their arena in one shot.
+   */
+  for (auto &task : _dispatchedTasks) {
+    acquireResources(task);
+  }
+  for (auto &task : _readyTasks) {
+    acquireResources(task);
+  }
+
+  _readyTasks.clear();
+  _dispatchedTasks.clear();
+  _completedTasks.clear();
+  _blockedTasks.clear();
+  _arrivals.clear();
+  _arriving.clear();
+  _index.clear();
+  _readyState.clear();
+  _completedState.clear();
+  _locks = LockManager(_locks.protocol());
+  _holders.clear();
+  _slots.clear();
+  _polled.clear();
+  _batch.resize(0);
+  _batch.setScale(0, 0);
+  _pool->release();
+  _arena->release();
+
+  _t = 0;
+  _n = 0;
+  _util = 0;
+  _density = 0;
+  _densities.clear();
+  _utils.clear();
+  _windows.clear();
+  _granules.clear();
+  _periods.clear();
+  _quantumSize = 0;
+  _hyperperiod = 1;
+  _compact = false;
+  _widened = false;
+  _energy = 0;
+  _peakPower = 0;
+  _mode = 0;
+  _switching = false;
+  _modeSwitches = 0;
+  _lostJobs = 0;
+  _lostWork = 0;
+}
+
+std::map<int, Task::OverheadStats> TaskSystem::overheadStats() const {
+  /* Collects the overheads charged to each task, by id.
+   */
+  std::map<int, Task::OverheadStats> stats;
+  for (auto subset : {&_readyTasks, &_dispatchedTasks, &_completedTasks,
+                      &_blockedTasks}) {
+    for (const auto &task : *subset) {
+      if (task != nullptr) {
+        stats[task->id()] = task->overheads();
+      }
+    }
+  }
+  return stats;
 }
 
 time_t TaskSystem::nextEventAt() const {
-  time_t nearest;
+  /* Returns the time until the nearest completion, deadline or
+     arrival, or the largest time_t when no event is pending.
+   */
+  auto nearest = std::numeric_limits<time_t>::max();
+  if (!_arrivals.empty()) {
+    nearest = _arrivals.begin()->first - _t;
+  }
   for (auto &task : _readyTasks) {
+    sync(*task);
     nearest = std::min({nearest, task->attrs().Ct, task->attrs().Dt});
   }
 
   for (auto &task : _completedTasks) {
+    sync(*task);
     nearest = std::min({nearest, task->attrs().Dt});
   }
 
   return nearest;
 };
 
-TaskState TaskSystem::operator()(const std::vector<int> &indices,
-                                 time_t proportion) {
+const TaskState &TaskSystem::operator()(const std::vector<int> &indices,
+                                        time_t proportion) {
   /* Dispatches tasks to run selected ready and
     idle the rest (and previously completed).
     Steps tasks to check for completed tasks and
@@ -245,24 +1106,39 @@ TaskState TaskSystem::operator()(const std::vector<int> &indices,
   }
 
   auto dt = _quantumSize * proportion;
-  dispatchTasks(indices, dt);
-  dispatchTasks(_readyTasks, dt);
-  dispatchTasks(_completedTasks, dt);
+  _power = 0;
+  _running.assign(_m, 0);
+  _moved = false;
+  dispatchTasks(acquireLocks(indices), dt);
+  idleTasks(dt);
+  if (_recorder != nullptr) {
+    _recorder->write(_t, dt, _running);
+  }
+
+  // Processors left in the pool idled through the step
+  for (auto &processor : _processors) {
+    _power += processor->power(false);
+  }
+  _energy += _power * dt;
+  _peakPower = std::max(_peakPower, _power);
+
+  // A LO budget overrun switches to HI mode, dropping pending LO jobs
+  // on the way through the tasks
+  auto switching = _switching;
+  if (switching) {
+    _mode = 1;
+    _modeSwitches += 1;
+    _switching = false;
+  }
 
   _t += dt;
-  for (auto &task : _dispatchedTasks) {
-    if (!task->stepped(_t)) {
-      continue;
-    }
+  reclassify(switching);
+  arrive();
 
-    acquireResources(task);
-    if (task->ready()) {
-      _readyTasks.emplace_back(std::move(task));
-    } else {
-      _completedTasks.emplace_back(std::move(task));
-    }
+  // Back to LO mode at the first idle instant
+  if (_mode > 0 && _readyTasks.empty() && _blockedTasks.empty()) {
+    _mode = 0;
   }
-  refresh(_dispatchedTasks);
 
   return readyState();
 }
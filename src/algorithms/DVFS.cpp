@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <vector>
+
+#include <DVFS.hpp>
+#include <Task.hpp>
+
+namespace DVFS {
+double staticSlowdown(double util, double capacity) {
+  /* Static voltage scaling: the platform runs just fast enough for
+     the total utilization, which keeps EDF feasible (U <= f * m).
+   */
+  return util / capacity;
+}
+
+double ccEDF(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &ready,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &completed,
+    double capacity) {
+  /* Cycle-conserving EDF: pending jobs count with their WCET,
+     completed jobs only with the time they actually ran (A, which
+     jobs end at when it is below C), until their next release.
+   */
+  double util = 0;
+  for (const auto &[id, params, attrs] : ready) {
+    util += params.U;
+  }
+  for (const auto &[id, params, attrs] : completed) {
+    util += static_cast<double>(params.A) / params.T;
+  }
+  return util / capacity;
+}
+
+double laEDF(
+    time_t t,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &ready,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &completed,
+    double capacity) {
+  /* Look-ahead EDF: defers as much pending work as possible past
+     the earliest deadline, then runs just fast enough to finish
+     the rest by it. Work is treated as a fluid over the platform.
+   */
+  struct Job {
+    time_t deadline;
+    time_t left;
+    double U;
+  };
+
+  std::vector<Job> jobs;
+  jobs.reserve(ready.size() + completed.size());
+  double util = 0;
+  for (const auto &[id, params, attrs] : ready) {
+    jobs.push_back({t + attrs.Dt, attrs.Ct, params.U});
+    util += params.U;
+  }
+  for (const auto &[id, params, attrs] : completed) {
+    jobs.push_back({t + attrs.Dt, 0, params.U});
+    util += params.U;
+  }
+  if (ready.empty()) {
+    return 0;
+  }
+
+  // Latest deadline first
+  std::sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) {
+    return a.deadline > b.deadline;
+  });
+  auto earliest = jobs.back().deadline;
+
+  double work = 0;
+  for (const auto &job : jobs) {
+    util -= job.U;
+    double span = job.deadline - earliest;
+    double x = std::max(0.0, job.left - ((capacity - util) * span));
+    if (span > 0) {
+      util += (job.left - x) / span;
+    }
+    work += x;
+  }
+
+  if (earliest <= t) {
+    return 1.0;
+  }
+  return work / (capacity * (earliest - t));
+}
+}; // namespace DVFS
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <vector>
+
+#include <Federated.hpp>
+#include <PriorityDriven.hpp>
+#include <Task.hpp>
+
+namespace Federated {
+Federation
+federate(const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const int &m) {
+  /* Federated scheduling of DAG tasks (Li et al.): a heavy task
+     (C > D) gets ceil((C - CP) / (D - CP)) dedicated processors,
+     light tasks share the rest sequentially under global EDF,
+     admitted by the GFB density bound on those processors.
+   */
+  Federation federation;
+  int used = 0;
+  double density = 0, densest = 0;
+  for (const auto &[id, params, attrs] : states) {
+    if (params.C <= params.D) {
+      auto delta =
+          static_cast<double>(params.C) / std::min(params.D, params.T);
+      density += delta;
+      densest = std::max(densest, delta);
+      continue;
+    }
+    if (params.CP >= params.D) {
+      return federation;
+    }
+    auto slack = params.D - params.CP;
+    auto cores = (params.C - params.CP + slack - 1) / slack;
+    federation.dedicated[id] = cores;
+    used += cores;
+  }
+
+  federation.shared = m - used;
+  auto shared = federation.shared;
+  // GFB: density <= m - (m - 1) * densest, light tasks need m > 0
+  auto fits = density == 0 ||
+              (shared > 0 && density <= shared - (shared - 1) * densest);
+  federation.feasible = shared >= 0 && fits;
+  return federation;
+}
+
+std::vector<int>
+schedule(time_t t, const int &m,
+         const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const Federation &federation) {
+  /* Runs each heavy task on up to its dedicated processors, then
+     the light ones, one processor each, by EDF on the shared ones.
+     On identical platforms only the number of processors matters,
+     so the dedicated ones are not pinned.
+   */
+  std::vector<int> indices;
+  std::vector<int> light;
+  for (int i = 0; i < states.size(); i++) {
+    const auto &[id, params, attrs] = states[i];
+    auto heavy = federation.dedicated.find(id);
+    if (heavy == federation.dedicated.end()) {
+      light.emplace_back(i);
+      continue;
+    }
+    for (int k = 0; k < std::min(heavy->second, attrs.Nt); k++) {
+      indices.emplace_back(i);
+    }
+  }
+
+  std::sort(light.begin(), light.end(), [&states](const int &a, const int &b) {
+    return std::tie(std::get<2>(states[a]).Dt, a) <
+           std::tie(std::get<2>(states[b]).Dt, b);
+  });
+  auto shared =
+      std::min<std::size_t>(std::max(federation.shared, 0), light.size());
+  indices.insert(indices.end(), light.begin(), light.begin() + shared);
+
+  return indices;
+}
+}; // namespace Federated
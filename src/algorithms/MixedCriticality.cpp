@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <MixedCriticality.hpp>
+#include <PriorityDriven.hpp>
+#include <Task.hpp>
+
+namespace MixedCriticality {
+Utilization utilization(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states) {
+  Utilization util;
+  for (const auto &[id, params, attrs] : states) {
+    if (params.L > 0) {
+      util.HILO += params.U;
+      util.HI += static_cast<double>(params.CH) / params.T;
+    } else {
+      util.LO += params.U;
+    }
+  }
+  return util;
+}
+
+double scaling(const Utilization &util, double capacity) {
+  /* EDF-VD deadline scaling factor x = U_HI(LO) / (1 - U_LO(LO)),
+     with the platform's total speed in place of 1.
+   */
+  if (util.LO >= capacity) {
+    return 1.0;
+  }
+  return std::min(1.0, util.HILO / (capacity - util.LO));
+}
+
+bool schedulable(const Utilization &util, double capacity) {
+  /* EDF-VD sufficient test x * U_LO(LO) + U_HI(HI) <= 1, again over
+     the total speed; exact on one processor, a fluid bound beyond.
+   */
+  if (util.LO + util.HI <= capacity) {
+    return true; // Plain EDF suffices
+  }
+  return (scaling(util, capacity) * util.LO) + util.HI <= capacity;
+}
+
+bool AMCrtb(
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states) {
+  /* AMC-rtb response-time test for the AMC priorities on one
+     processor (or one partition). Every task must meet its deadline
+     in LO mode,
+       R(LO) = C + sum over higher j of ceil(R(LO) / Tj) Cj,
+     and every HI task across the switch, where higher HI tasks run at
+     their HI budget and higher LO ones only until R(LO):
+       R(HI) = CH + sum over higher HI j of ceil(R(HI) / Tj) CHj
+                  + sum over higher LO k of ceil(R(LO) / Tk) Ck.
+   */
+  auto priority = [](const Task::Parameters &params) {
+    return (2 * params.D) + (params.L > 0 ? 0 : 1);
+  };
+  std::vector<const Task::Parameters *> tasks;
+  for (const auto &[id, params, attrs] : states) {
+    tasks.emplace_back(&params);
+  }
+  std::stable_sort(tasks.begin(), tasks.end(),
+                   [&priority](const Task::Parameters *a,
+                               const Task::Parameters *b) {
+                     return priority(*a) < priority(*b);
+                   });
+
+  // Iterates R = base + interference(R) to its fixed point, or until
+  // it passes the deadline
+  auto respond = [](time_t base, time_t D, const auto &interference) {
+    time_t R = base;
+    while (R <= D) {
+      auto next = base + interference(R);
+      if (next == R) {
+        return R;
+      }
+      R = next;
+    }
+    return R;
+  };
+  auto jobs = [](time_t R, time_t T) { return (R + T - 1) / T; };
+
+  for (std::size_t i = 0; i < tasks.size(); i++) {
+    const auto &task = *tasks[i];
+    auto lo = respond(task.C, task.D, [&](time_t R) {
+      time_t load = 0;
+      for (std::size_t j = 0; j < i; j++) {
+        load += jobs(R, tasks[j]->T) * tasks[j]->C;
+      }
+      return load;
+    });
+    if (lo > task.D) {
+      return false;
+    }
+    if (task.L == 0) {
+      continue;
+    }
+
+    auto hi = respond(task.CH, task.D, [&](time_t R) {
+      time_t load = 0;
+      for (std::size_t j = 0; j < i; j++) {
+        const auto &other = *tasks[j];
+        load += other.L > 0 ? jobs(R, other.T) * other.CH
+                            : jobs(lo, other.T) * other.C;
+      }
+      return load;
+    });
+    if (hi > task.D) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int>
+EDFVD(time_t t, const int &m,
+      const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+          &states,
+      double x, int mode) {
+  /* EDF with virtual deadlines: in LO mode, HI tasks are scheduled
+     by a deadline shortened to x * D; in HI mode by the real one.
+   */
+  return PriorityDriven::schedule(
+      m, states,
+      [x, mode](const Task::Parameters &params, const Task::Attributes &attrs) {
+        if (mode > 0 || params.L == 0) {
+          return attrs.Dt;
+        }
+        auto virtualD = static_cast<time_t>(std::floor(x * params.D));
+        return attrs.Dt - (params.D - virtualD);
+      });
+}
+
+std::vector<int>
+AMC(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states) {
+  /* Adaptive mixed criticality: fixed deadline-monotonic priorities,
+     HI tasks first among equal deadlines. LO jobs are dropped by the
+     task system on the mode switch. AMCrtb tests these priorities on
+     one processor.
+   */
+  return PriorityDriven::schedule(
+      m, states,
+      [](const Task::Parameters &params, const Task::Attributes &attrs) {
+        return (2 * params.D) + (params.L > 0 ? 0 : 1);
+      });
+}
+}; // namespace MixedCriticality
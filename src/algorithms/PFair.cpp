@@ -6,10 +6,99 @@
 #include <PFair.hpp>
 #include <Task.hpp>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PFAIR_X86 1
+#endif
+
 namespace PFair {
+namespace {
+void classifyScalar(time_t t, const Batch &batch, Classes &classes,
+                    std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; i++) {
+    const double now = t - batch.O[i], next = now + 1;
+    double lag = (now * batch.U[i]) - batch.W[i];
+    double value = (next * batch.U[i]) - std::floor(now * batch.U[i]) - 1;
+
+    uint64_t bit = uint64_t(1) << (i & 63);
+    if ((lag > 0) && !(value < 0)) {
+      classes.urgent[i >> 6] |= bit;
+    } else if ((lag < 0) && !(value > 0)) {
+      classes.tnegru[i >> 6] |= bit;
+    } else {
+      classes.contending[i >> 6] |= bit;
+    }
+  }
+}
+
+#if PFAIR_X86
+__attribute__((target("sse4.2"))) void
+classifySSE42(time_t t, const Batch &batch, Classes &classes) {
+  const std::size_t n = batch.U.size();
+  const __m128d vt = _mm_set1_pd(t);
+  const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1);
+
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d now = _mm_sub_pd(vt, _mm_loadu_pd(&batch.O[i]));
+    __m128d next = _mm_add_pd(now, one);
+    __m128d U = _mm_loadu_pd(&batch.U[i]);
+    __m128d tU = _mm_mul_pd(now, U);
+    __m128d lag = _mm_sub_pd(tU, _mm_loadu_pd(&batch.W[i]));
+    __m128d value =
+        _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(next, U), _mm_floor_pd(tU)), one);
+
+    int behind = _mm_movemask_pd(_mm_cmpgt_pd(lag, zero));
+    int ahead = _mm_movemask_pd(_mm_cmplt_pd(lag, zero));
+    int negative = _mm_movemask_pd(_mm_cmplt_pd(value, zero));
+    int positive = _mm_movemask_pd(_mm_cmpgt_pd(value, zero));
+
+    int urgent = behind & ~negative;
+    int tnegru = ahead & ~positive;
+    classes.urgent[i >> 6] |= uint64_t(urgent) << (i & 63);
+    classes.tnegru[i >> 6] |= uint64_t(tnegru) << (i & 63);
+    classes.contending[i >> 6] |= uint64_t(~(urgent | tnegru) & 0x3)
+                                  << (i & 63);
+  }
+  classifyScalar(t, batch, classes, i, n);
+}
+
+__attribute__((target("avx2"))) void
+classifyAVX2(time_t t, const Batch &batch, Classes &classes) {
+  const std::size_t n = batch.U.size();
+  const __m256d vt = _mm256_set1_pd(t);
+  const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d now = _mm256_sub_pd(vt, _mm256_loadu_pd(&batch.O[i]));
+    __m256d next = _mm256_add_pd(now, one);
+    __m256d U = _mm256_loadu_pd(&batch.U[i]);
+    __m256d tU = _mm256_mul_pd(now, U);
+    __m256d lag = _mm256_sub_pd(tU, _mm256_loadu_pd(&batch.W[i]));
+    __m256d value = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_mul_pd(next, U), _mm256_floor_pd(tU)), one);
+
+    int behind = _mm256_movemask_pd(_mm256_cmp_pd(lag, zero, _CMP_GT_OQ));
+    int ahead = _mm256_movemask_pd(_mm256_cmp_pd(lag, zero, _CMP_LT_OQ));
+    int negative = _mm256_movemask_pd(_mm256_cmp_pd(value, zero, _CMP_LT_OQ));
+    int positive = _mm256_movemask_pd(_mm256_cmp_pd(value, zero, _CMP_GT_OQ));
+
+    int urgent = behind & ~negative;
+    int tnegru = ahead & ~positive;
+    classes.urgent[i >> 6] |= uint64_t(urgent) << (i & 63);
+    classes.tnegru[i >> 6] |= uint64_t(tnegru) << (i & 63);
+    classes.contending[i >> 6] |= uint64_t(~(urgent | tnegru) & 0xF)
+                                  << (i & 63);
+  }
+  classifyScalar(t, batch, classes, i, n);
+}
+#endif
+} // namespace
+
 double computeLag(time_t t, const Task::Parameters &params,
                   const Task::Attributes &attrs) {
-  return Lag(t, params.C, attrs.Ct, params.U, attrs.releases);
+  return Lag(t - params.O, params.C, attrs.Ct, params.U, attrs.releases);
 }
 
 double computeLag(const Task::Parameters &params,
@@ -20,7 +109,7 @@ double computeLag(const Task::Parameters &params,
 
 int getSymbol(time_t t, const Task::Parameters &params,
               const Task::Attributes &attrs) {
-  return Symbol(t, params.C, params.U);
+  return Symbol(t - params.O, params.C, params.U);
 }
 
 int getSymbol(const Task::Parameters &params, const Task::Attributes &attrs) {
@@ -28,6 +117,30 @@ int getSymbol(const Task::Parameters &params, const Task::Attributes &attrs) {
   return Symbol(t, params.C, params.U);
 }
 
+void classify(time_t t, const Batch &batch, Classes &classes) {
+  /* Evaluates the lag and characteristic-string symbol of all tasks
+     at time t (relative to each one's join time) and sorts them
+     into urgent, tnegru and contending.
+   */
+  const std::size_t words = (batch.U.size() + 63) / 64;
+  classes.urgent.assign(words, 0);
+  classes.tnegru.assign(words, 0);
+  classes.contending.assign(words, 0);
+
+  switch (Kernels::level()) {
+#if PFAIR_X86
+  case Kernels::Level::AVX2:
+    classifyAVX2(t, batch, classes);
+    break;
+  case Kernels::Level::SSE42:
+    classifySSE42(t, batch, classes);
+    break;
+#endif
+  default:
+    classifyScalar(t, batch, classes, 0, batch.U.size());
+  }
+}
+
 std::vector<int>
 PF(time_t t, const int &m,
    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
@@ -35,24 +148,27 @@ PF(time_t t, const int &m,
   std::vector<int> indices;
   std::vector<int> contendingIndices;
 
-  for (int i = 0; i < states.size(); i++) {
-    auto [id, params, attrs] = states[i];
-
-    double lag = computeLag(t, params, attrs);
-    double lag2 = computeLag(params, attrs);
-    assert(std::abs(lag - lag2) < 1e-4);
+  // Reused across quanta, PF runs every step
+  static thread_local Batch batch;
+  static thread_local Classes classes;
 
-    int symbol = getSymbol(t, params, attrs);
-    int symbol2 = getSymbol(t, params, attrs);
-    assert(symbol == symbol2);
+  batch.U.resize(states.size());
+  batch.W.resize(states.size());
+  batch.O.resize(states.size());
+  for (int i = 0; i < states.size(); i++) {
+    const auto &[id, params, attrs] = states[i];
+    batch.U[i] = params.U;
+    batch.W[i] = (attrs.releases * params.C) - attrs.Ct;
+    batch.O[i] = params.O;
+  }
+  classify(t, batch, classes);
 
-    if ((lag > 0) && (symbol >= 0)) {
+  for (int i = 0; i < states.size(); i++) {
+    if (Kernels::test(classes.urgent, i)) {
       // Urgent: behind AND +ve symbol
       indices.emplace_back(i);
-    } else if ((lag < 0) && (symbol <= 0)) {
-      // Tnegru: ahead AND +ve symbol, DO NOTHING
-    } else {
-      // Other tasks
+    } else if (Kernels::test(classes.contending, i)) {
+      // Other tasks; tnegru (ahead AND -ve symbol) DO NOTHING
       contendingIndices.emplace_back(i);
     }
   }
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <PriorityDriven.hpp>
+#include <Task.hpp>
+
+namespace PriorityDriven {
+std::vector<int>
+schedule(const int &m,
+         const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+             &states,
+         const Priority &priority) {
+  /* Selects up to m ready tasks with the highest priority, returned
+     highest first so the dispatcher places them on the fastest
+     processors (as required on uniform platforms).
+     Ties are broken by ready index. A parallel task is selected
+     once per ready node (Nt), as long as processors remain.
+   */
+  std::vector<time_t> keys;
+  keys.reserve(states.size());
+  for (const auto &[id, params, attrs] : states) {
+    keys.emplace_back(priority(params, attrs));
+  }
+
+  std::vector<int> indices(states.size());
+  std::iota(indices.begin(), indices.end(), 0);
+
+  auto count = std::min<std::size_t>(m, indices.size());
+  std::partial_sort(indices.begin(), indices.begin() + count, indices.end(),
+                    [&keys](const int &a, const int &b) {
+                      return std::tie(keys[a], a) < std::tie(keys[b], b);
+                    });
+  indices.resize(count);
+
+  std::vector<int> selected;
+  selected.reserve(m);
+  for (auto i : indices) {
+    const auto &attrs = std::get<2>(states[i]);
+    for (int k = 0; k < attrs.Nt && selected.size() < m; k++) {
+      selected.emplace_back(i);
+    }
+  }
+
+  return selected;
+}
+
+std::vector<int>
+EDF(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states) {
+  return schedule(m, states, Deadline);
+}
+
+std::vector<int>
+DM(time_t t, const int &m,
+   const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+       &states) {
+  return schedule(m, states, RelativeDeadline);
+}
+
+std::vector<int>
+LLF(time_t t, const int &m,
+    const std::vector<std::tuple<int, Task::Parameters, Task::Attributes>>
+        &states) {
+  return schedule(m, states, Laxity);
+}
+}; // namespace PriorityDriven
@@ -1,9 +1,17 @@
+#include <Replay.hpp>
 #include <TaskSystem.hpp>
+#include <algorithms/DVFS.hpp>
+#include <algorithms/Federated.hpp>
 #include <algorithms/PFair.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
+#include <iostream>
+#include <map>
 #include <memory>
 #include <ncurses.h>
 #include <sstream>
@@ -11,20 +19,123 @@
 
 using namespace std::chrono_literals;
 
+int browse(const std::string &filename) {
+  /* Browses a recorded run: arrows step a column, PgUp/PgDn a screen,
+     +/- zoom in and out, Home/End jump to either end, g seeks to a
+     time and q quits.
+   */
+  Replay replay(filename);
+  if (!replay.valid()) {
+    return 1;
+  }
+
+  Display display(replay.M());
+  keypad(stdscr, TRUE);
+  noecho();
+
+  auto columns = display.traceColumns();
+  time_t from = replay.begin(), zoom = 1;
+  while (true) {
+    std::ostringstream status;
+    status << "Replay " << filename << "  t = " << from << "/" << replay.end()
+           << "  " << zoom << " tick(s)/column  [arrows, PgUp/PgDn, +/-, "
+           << "Home/End, g, q]";
+    move(1, 1);
+    clrtoeol();
+    display.updateStatus(status.str());
+    display.drawReplay(from, zoom, replay.window(from, columns, zoom));
+
+    auto last = std::max(replay.begin(), replay.end() - (columns * zoom));
+    switch (getch()) {
+    case KEY_LEFT:
+      from -= zoom;
+      break;
+    case KEY_RIGHT:
+      from += zoom;
+      break;
+    case KEY_PPAGE:
+      from -= columns * zoom;
+      break;
+    case KEY_NPAGE:
+      from += columns * zoom;
+      break;
+    case '+':
+      zoom = std::max<time_t>(zoom / 2, 1);
+      break;
+    case '-':
+      zoom *= 2;
+      break;
+    case KEY_HOME:
+      from = replay.begin();
+      break;
+    case KEY_END:
+      from = last;
+      break;
+    case 'g': {
+      char input[32]{};
+      move(1, 1);
+      clrtoeol();
+      mvprintw(1, 1, "Go to time: ");
+      echo();
+      getnstr(input, sizeof(input) - 1);
+      noecho();
+      from = std::atol(input);
+      break;
+    }
+    case 'q':
+      return 0;
+    }
+    from = std::clamp(from, replay.begin(), std::max(last, replay.begin()));
+  }
+}
+
 int main(int argc, char **argv) {
+  if (argc == 3 && std::string(argv[1]) == "--replay") {
+    return browse(argv[2]);
+  }
+
   std::string str;
   std::for_each(argv + 1, argv + argc,
                 [&](const char *c_str) { str += std::string(c_str) + " "; });
 
-  std::string filename;
+  std::string filename, scheduler = "pFair", recording;
   int m = 2, L = 0; // m is number of processors and L is number of steps
   if (!str.empty()) {
     std::istringstream strStream(str);
-    strStream >> filename >> m >> L;
+    strStream >> filename >> m >> L >> scheduler >> recording;
+  }
+
+  using Scheduler =
+      std::function<std::vector<int>(time_t, const int &, const TaskState &)>;
+  std::map<std::string, Scheduler> schedulers{
+      {"pFair", PFair::PF},
+      {"EDF", PriorityDriven::EDF},
+      {"DM", PriorityDriven::DM},
+      {"LLF", PriorityDriven::LLF},
+      {"ccEDF", PriorityDriven::EDF},
+      {"laEDF", PriorityDriven::EDF}};
+  if (schedulers.count(scheduler) == 0 && scheduler != "Federated") {
+    std::cout << "Unknown scheduler: " << scheduler << std::endl;
+    return 1;
   }
+  auto schedule = schedulers[scheduler];
 
   TaskSystem system = TaskSystem(m, true);
   system.loadTasks(filename);
+  if (!recording.empty()) {
+    system.record(recording);
+  }
+  if (scheduler == "Federated") {
+    // Processors are split among the tasks once, at load
+    auto federation = Federated::federate(system.readyState(), m);
+    schedule = [federation](time_t t, const int &m, const TaskState &states) {
+      return Federated::schedule(t, m, states, federation);
+    };
+  }
+  if (scheduler == "ccEDF" || scheduler == "laEDF") {
+    system.setOperatingPoints(
+        {{0.25, 0.6}, {0.5, 0.7}, {0.75, 0.85}, {1.0, 1.0}});
+  }
   if (L == 0) {
     L = system.H();
   }
@@ -40,7 +151,15 @@ int main(int argc, char **argv) {
     }
 
     t = system.T();
-    auto indices = PFair::PF(t, m, state);
+    if (scheduler == "ccEDF") {
+      // Slows down as jobs complete early, back up on release
+      system.setFrequency(
+          DVFS::ccEDF(state, system.completedState(), system.capacity()));
+    } else if (scheduler == "laEDF") {
+      system.setFrequency(DVFS::laEDF(t, state, system.completedState(),
+                                      system.capacity()));
+    }
+    auto indices = schedule(t, m, state);
     assert(indices.size() <= m);
 
     state = system.operator()(indices);
@@ -0,0 +1,101 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+
+namespace {
+class CountingResource : public std::pmr::memory_resource {
+  /* Forwards to the heap and counts the bytes still handed out.
+   */
+public:
+  std::size_t outstanding() const { return _outstanding; };
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    _outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    _outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  std::size_t _outstanding{0};
+};
+
+std::size_t run(TaskSystem &system, time_t until) {
+  /* Steps an EDF schedule and hashes the states it goes through.
+     Ids count on across loads, so they are left out.
+   */
+  std::size_t hash = 0;
+  while (system.T() < until) {
+    const auto &state = system(
+        PriorityDriven::EDF(system.T(), system.M(), system.readyState()));
+    for (const auto &[id, params, attrs] : state) {
+      hash = (hash * 31) ^ std::hash<time_t>{}((attrs.Ct << 16) + attrs.Dt);
+    }
+  }
+  return hash;
+}
+
+void releasesOnClear() {
+  /* clear hands the whole arena back upstream, and the same system
+     then reloads and replays the task set as it did the first time.
+   */
+  CountingResource upstream;
+  TaskSystem system(2, false, &upstream);
+  system.loadTasks("tasksets/example.txt");
+  CHECK(upstream.outstanding() > 0);
+  auto first = run(system, 200);
+
+  system.clear();
+  CHECK(upstream.outstanding() == 0);
+  CHECK(system.N() == 0);
+  CHECK(system.readyState().empty());
+
+  system.loadTasks("tasksets/example.txt");
+  CHECK(upstream.outstanding() > 0);
+  CHECK(run(system, 200) == first);
+
+  system.clear();
+  CHECK(upstream.outstanding() == 0);
+  CHECK(system.admitTask(Task::Parameters{1, 4}) != 0);
+  run(system, 20);
+  CHECK(system.T() == 20);
+}
+
+void recyclesRetiredTasks() {
+  /* Tasks that retire hand their storage to the pool, so admitting
+     and retiring in a loop stops drawing from upstream.
+   */
+  CountingResource upstream;
+  TaskSystem system(1, false, &upstream);
+  system.addTask(Task::Parameters{1, 4});
+  std::size_t steady = 0;
+  for (int i = 0; i < 50; i++) {
+    auto id = system.admitTask(Task::Parameters{2, 5});
+    CHECK(id != 0);
+    CHECK(system.retireTask(id));
+    while (system.task(id) != nullptr) {
+      run(system, system.T() + 1);
+    }
+    if (i == 1) {
+      steady = upstream.outstanding();
+    }
+  }
+  CHECK(upstream.outstanding() == steady);
+}
+} // namespace
+
+int main() {
+  releasesOnClear();
+  recyclesRetiredTasks();
+  return 0;
+}
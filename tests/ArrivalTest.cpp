@@ -0,0 +1,108 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/PFair.hpp>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace {
+using Trace = std::vector<std::tuple<time_t, int, time_t, time_t>>;
+
+Trace run(bool moves) {
+  /* Runs PF on the example task set on two processors, with tasks
+     joining later and leaving, and traces the ready jobs. With moves
+     the system is moved out and back every 100 steps, as main does.
+   */
+  TaskSystem system(2);
+  system.loadTasks("tasksets/example.txt");
+  auto first = std::get<0>(system.readyState().front());
+  CHECK(system.admitTask(Task::Parameters{1, 10, 0, 30}) != 0);
+  auto late = system.admitTask(Task::Parameters{1, 50, 0, 250});
+  CHECK(late != 0);
+
+  Trace trace;
+  auto state = system.readyState();
+  for (int i = 0; i < 2 * system.H(); i++) {
+    if (moves && i != 0 && i % 100 == 0) {
+      TaskSystem snapshot(std::move(system));
+      system = std::move(snapshot);
+      state = system.readyState();
+    }
+    if (i == 120) {
+      CHECK(system.retireTask(late)); // Still to arrive, leaves at once
+      CHECK(system.task(late) == nullptr);
+    }
+    if (i == 150) {
+      CHECK(system.retireTask(first));
+    }
+
+    state = system(PFair::PF(system.T(), 2, state));
+    for (const auto &[id, params, attrs] : state) {
+      trace.emplace_back(system.T(), id, attrs.Ct, attrs.Dt);
+    }
+  }
+  CHECK(system.task(first) == nullptr);
+  return trace;
+}
+
+void survivesMoves() {
+  /* Moving the system keeps the pending arrivals and their index.
+   */
+  auto trace = run(false);
+  CHECK(trace == run(true));
+}
+
+void findsTheNextEvent() {
+  /* With nothing pending there is no next event; a later arrival is
+     one.
+   */
+  TaskSystem system(1);
+  CHECK(system.nextEventAt() == std::numeric_limits<time_t>::max());
+  system.addTask(Task::Parameters{1, 4, 0, 6});
+  CHECK(system.nextEventAt() == 6);
+  system.addTask(Task::Parameters{3, 4});
+  CHECK(system.nextEventAt() == 3);
+}
+
+void throwsOnOvercommit() {
+  /* Adding beyond the capacity throws, even with assertions off,
+     and leaves the system as it was.
+   */
+  TaskSystem system(1);
+  system.addTask(Task::Parameters{3, 4});
+  CHECK_THROWS(system.addTask(Task::Parameters{2, 4}));
+  CHECK_THROWS(system.addDagTask(4, 4, {{1, {1}}, {1, {}}}));
+  CHECK_THROWS(system.addServer(ServerTask::Kind::DEFERRABLE, 2, 4,
+                                std::make_unique<PoissonArrivals>(4, 1)));
+  CHECK(system.util() == 0.75);
+  CHECK(system.readyState().size() == 1);
+  CHECK(system.addTask(Task::Parameters{1, 4}) != 0);
+}
+
+void boundsUniformPlatforms() {
+  /* On speeds {2, 1}, lambda = 1/2: U <= 3 - 0.5 u_max, and the same
+     over densities when they are tested.
+   */
+  TaskSystem system(std::vector<double>{2.0, 1.0});
+  CHECK(system.admitTask(Task::Parameters{2, 2}) != 0);
+  CHECK(system.admitTask(Task::Parameters{2, 2}) != 0);
+  CHECK(system.admitTask(Task::Parameters{1, 2}) != 0);
+  CHECK(system.admitTask(Task::Parameters{1, 4}) == 0); // 2.75 > 2.5
+
+  TaskSystem constrained(std::vector<double>{2.0, 1.0});
+  constrained.setAdmission(TaskSystem::Admission::DENSITY);
+  CHECK(constrained.admitTask(Task::Parameters{1, 4, 1}) != 0);
+  CHECK(constrained.admitTask(Task::Parameters{1, 4, 1}) != 0);
+  CHECK(constrained.admitTask(Task::Parameters{1, 4, 2}) != 0);
+  CHECK(constrained.admitTask(Task::Parameters{1, 4, 4}) == 0);
+  CHECK(constrained.util() == 0.75);
+}
+} // namespace
+
+int main() {
+  survivesMoves();
+  findsTheNextEvent();
+  throwsOnOvercommit();
+  boundsUniformPlatforms();
+  return 0;
+}
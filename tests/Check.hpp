@@ -0,0 +1,31 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/* Checks for the headless regression tests. Unlike assert they stay
+   on in release builds; the first failure ends the test.
+ */
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #condition);                                                \
+      std::exit(1);                                                            \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_THROWS(statement)                                                \
+  do {                                                                         \
+    bool thrown = false;                                                       \
+    try {                                                                      \
+      statement;                                                               \
+    } catch (const std::exception &) {                                         \
+      thrown = true;                                                           \
+    }                                                                          \
+    CHECK(thrown);                                                             \
+  } while (0)
+
+#endif
@@ -0,0 +1,57 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/DVFS.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <vector>
+
+namespace {
+enum Policy { FULL, STATIC, CC_EDF, LA_EDF };
+
+double run(Policy policy) {
+  /* Runs EDF over four hyperperiods on one processor, with every job
+     completing after half of its WCET, and returns the energy spent.
+     A deadline miss throws and fails the test.
+   */
+  TaskSystem system(1);
+  system.setOperatingPoints(
+      {{0.25, 0.6}, {0.5, 0.7}, {0.75, 0.85}, {1.0, 1.0}});
+  for (auto [C, T] : std::vector<std::pair<time_t, time_t>>{
+           {2, 8}, {4, 16}, {2, 10}, {2, 20}, {4, 40}}) {
+    Task::Parameters params(C, T);
+    params.A = C / 2;
+    system.addTask(params);
+  }
+
+  auto state = &system.readyState();
+  while (system.T() < 4 * system.H()) {
+    auto &completed = system.completedState();
+    double frequency = 1.0;
+    if (policy == STATIC) {
+      frequency = DVFS::staticSlowdown(system.util(), system.capacity());
+    } else if (policy == CC_EDF) {
+      frequency = DVFS::ccEDF(*state, completed, system.capacity());
+    } else if (policy == LA_EDF) {
+      frequency =
+          DVFS::laEDF(system.T(), *state, completed, system.capacity());
+    }
+    system.setFrequency(frequency);
+    state = &system(PriorityDriven::EDF(system.T(), 1, *state));
+  }
+  return system.energy();
+}
+
+void savesOnEarlyCompletion() {
+  /* U = 0.9 needs full speed under static slowdown, while reclaiming
+     the unused budget of early completions runs slower.
+   */
+  auto full = run(FULL);
+  CHECK(run(STATIC) == full);
+  CHECK(run(CC_EDF) < full);
+  CHECK(run(LA_EDF) < full);
+}
+} // namespace
+
+int main() {
+  savesOnEarlyCompletion();
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/Federated.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+void derivesVolumeAndCriticalPath() {
+  /* A fork-join of 1 -> {2, 3} -> 1 has volume 7 and critical path 5.
+   */
+  auto params = DagTask::parameters(10, 10, {{1, {1, 2}}, {2, {3}},
+                                             {3, {3}}, {1, {}}});
+  CHECK(params.C == 7);
+  CHECK(params.CP == 5);
+  DagTask task(10, 10, {{1, {1, 2}}, {2, {3}}, {3, {3}}, {1, {}}});
+  CHECK(task.params().CP == 5);
+  CHECK(task.attrs().Nt == 1);
+}
+
+void rejectsInvalidSuccessors() {
+  /* A successor outside the graph, or before its node, rejects the
+     whole file.
+   */
+  auto path = std::filesystem::temp_directory_path() / "DagTest.txt";
+  for (auto successor : {"2", "0"}) {
+    std::ofstream(path) << "0.5\n2\n1, 4\nDAG 10, 10, 2\n1: "
+                        << successor << "\n1:\n";
+    TaskSystem system(2);
+    system.loadTasks(path.string());
+    CHECK(system.readyState().empty());
+  }
+  std::filesystem::remove(path);
+}
+
+void dropsDagJobsOnOverrun() {
+  /* A LO DAG job dropped at a mode switch leaves no work behind,
+     so its laxity does not turn into a false miss.
+   */
+  TaskSystem system(2);
+  Task::Parameters hi(1, 5);
+  hi.L = 1;
+  hi.CH = hi.A = 4;
+  system.addTask(hi);
+  system.addDagTask(20, 20, {{4, {1}}, {4, {}}});
+
+  auto state = &system.readyState();
+  while (system.T() < 40) {
+    state = &system(PriorityDriven::EDF(system.T(), 2, *state));
+  }
+  CHECK(system.lostJobs() > 0);
+}
+
+void admitsLightTasksByDensity() {
+  /* Three light tasks of density 0.6 fit two processors by total
+     utilization, but not by GFB: 1.8 > 2 - 0.6.
+   */
+  TaskState states;
+  for (int id = 1; id <= 3; id++) {
+    Task::Parameters params(6, 10);
+    states.emplace_back(id, params, Task::Attributes(params));
+  }
+  CHECK(!Federated::federate(states, 2).feasible);
+  states.pop_back();
+  CHECK(Federated::federate(states, 2).feasible);
+
+  // A heavy task takes both processors, none left for the light ones
+  Task::Parameters heavy(12, 8);
+  heavy.CP = 4;
+  states.emplace_back(4, heavy, Task::Attributes(heavy));
+  auto federation = Federated::federate(states, 3);
+  CHECK(federation.dedicated[4] == 2 && federation.shared == 1);
+  CHECK(!federation.feasible);
+  states.erase(states.begin());
+  CHECK(Federated::federate(states, 3).feasible);
+}
+} // namespace
+
+int main() {
+  derivesVolumeAndCriticalPath();
+  rejectsInvalidSuccessors();
+  dropsDagJobsOnOverrun();
+  admitsLightTasksByDensity();
+  return 0;
+}
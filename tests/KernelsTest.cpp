@@ -0,0 +1,200 @@
+#include "Check.hpp"
+#include <Kernels.hpp>
+#include <TaskSystem.hpp>
+#include <algorithms/PFair.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+struct Times {
+  time_t Ct, Dt, D, t, next;
+};
+
+std::vector<Kernels::Level> levels() {
+  /* The instruction sets the running CPU supports, scalar first.
+   */
+  std::vector<Kernels::Level> supported;
+  for (auto level : {Kernels::Level::SCALAR, Kernels::Level::SSE42,
+                     Kernels::Level::AVX2}) {
+    if (level <= Kernels::detect()) {
+      supported.emplace_back(level);
+    }
+  }
+  return supported;
+}
+
+void batchStepsLikeTasks() {
+  /* Every kernel, wide and compact, steps each slot as a task would
+     and flags the same misses and releases. An odd count of slots
+     covers the scalar tails of the vector loops.
+   */
+  std::mt19937 rng(1);
+  std::vector<Times> slots(37);
+  for (auto &s : slots) {
+    s.D = 2 * (1 + rng() % 20);
+    s.Ct = 2 * (rng() % 4);
+    s.Dt = 2 * (rng() % 12) - 4;
+    s.t = 100 + (2 * (rng() % 50));
+    s.next = s.t + (2 * (rng() % 3));
+  }
+  slots[3].next = std::numeric_limits<time_t>::max(); // Never released
+
+  for (auto level : levels()) {
+    for (time_t quantum : {0, 1, 2}) {
+      Kernels::setLevel(level);
+      Kernels::Batch batch;
+      batch.resize(slots.size());
+      for (std::size_t i = 0; i < slots.size(); i++) {
+        const auto &s = slots[i];
+        batch.pack(i, s.Ct, s.Dt, s.D, s.t, s.next);
+      }
+      batch.setScale(quantum, 100);
+      CHECK(batch.compact() == (quantum > 0));
+
+      Kernels::Mask misses, releases;
+      Kernels::advance(batch, 2, misses, releases);
+      CHECK(batch.compact() == (quantum > 0));
+      for (std::size_t i = 0; i < slots.size(); i++) {
+        const auto &s = slots[i];
+        auto slot = batch.slot(i);
+        auto Lt = s.Dt - 2 - s.Ct;
+        CHECK(slot.t == s.t + 2);
+        CHECK(slot.Dt == s.Dt - 2);
+        CHECK(slot.Lt == Lt);
+        CHECK(slot.Rt == s.D - Lt);
+        CHECK(Kernels::test(misses, i) == (Lt < 0 && s.Ct > 0));
+        CHECK(Kernels::test(releases, i) == (s.t + 2 >= s.next));
+      }
+    }
+  }
+  Kernels::setLevel(Kernels::detect());
+}
+
+void batchKeepsSlots() {
+  /* Slots hold their times across rescaling, widening and the move
+     that fills the hole of a leaving task.
+   */
+  Kernels::Batch batch;
+  batch.resize(3);
+  batch.pack(0, 4, 10, 12, 6, 12);
+  batch.pack(1, 2, 8, 8, 6, 14);
+  batch.pack(2, 0, 2, 4, 6, std::numeric_limits<time_t>::max());
+  batch.setScale(2, 6);
+  CHECK(batch.compact());
+
+  batch.move(2, 0);
+  batch.resize(2);
+  batch.pack(1, 3, 8, 8, 6, 14); // Not a whole quantum
+  CHECK(!batch.compact());
+  auto slot = batch.slot(0);
+  CHECK(slot.t == 6 && slot.Dt == 2 && slot.Lt == 2 && slot.Rt == 2);
+  CHECK(batch.times.next[0] == std::numeric_limits<time_t>::max());
+  slot = batch.slot(1);
+  CHECK(slot.Dt == 8 && slot.Lt == 5 && slot.Rt == 3);
+}
+
+unsigned long run(Kernels::Level level, bool compact) {
+  /* Hashes the states of a PF schedule of the example task set, and
+     checks that tasks read back the times their states show.
+   */
+  Kernels::setLevel(level);
+  TaskSystem system(2);
+  system.loadTasks("tasksets/example.txt");
+  system.setCompact(compact);
+  CHECK(system.compact() == compact);
+
+  unsigned long hash = 1469598103934665603UL;
+  auto mix = [&hash](long v) {
+    hash = (hash ^ static_cast<unsigned long>(v)) * 1099511628211UL;
+  };
+  auto state = system.readyState();
+  for (int step = 0; step < 600; step++) {
+    state = system(PFair::PF(system.T(), system.M(), state));
+    for (const auto &[id, params, attrs] : state) {
+      const auto &synced = system.task(id)->attrs();
+      CHECK(synced.Dt == attrs.Dt && synced.Lt == attrs.Lt &&
+            synced.Rt == attrs.Rt);
+      for (auto v : {static_cast<time_t>(id), attrs.Ct, attrs.Dt, attrs.Lt,
+                     attrs.Rt, attrs.releases}) {
+        mix(v);
+      }
+    }
+  }
+  return hash;
+}
+
+void systemStepsAlikeOnAllKernels() {
+  auto expected = run(Kernels::Level::SCALAR, false);
+  for (auto level : levels()) {
+    CHECK(run(level, false) == expected);
+    CHECK(run(level, true) == expected);
+  }
+  Kernels::setLevel(Kernels::detect());
+}
+
+unsigned long runPrimes(bool compact) {
+  /* Hashes an EDF schedule of tasks with prime periods, whose
+     hyperperiod is far beyond 32-bit quanta.
+   */
+  TaskSystem system(4);
+  for (time_t T : {997, 991, 983, 977}) {
+    system.addTask(Task::Parameters{300, T});
+  }
+  system.setCompact(compact);
+  CHECK(system.H() > Kernels::maxQuanta); // In quanta of 1
+  CHECK(system.compact() == compact);
+
+  unsigned long hash = 1469598103934665603UL;
+  auto state = system.readyState();
+  for (int step = 0; step < 3000; step++) {
+    state = system(PriorityDriven::EDF(system.T(), system.M(), state));
+    for (const auto &[id, params, attrs] : state) {
+      for (auto v : {static_cast<time_t>(id), attrs.Ct, attrs.Dt}) {
+        hash = (hash ^ static_cast<unsigned long>(v)) * 1099511628211UL;
+      }
+    }
+  }
+  CHECK(system.compact() == compact);
+  return hash;
+}
+
+void compactBeyondTheHyperperiod() {
+  /* Compact lanes only need the longest window to fit, not the
+     hyperperiod.
+   */
+  CHECK(runPrimes(true) == runPrimes(false));
+}
+
+void staysWideAfterFallingBack() {
+  /* A CBS server serving odd amounts of work leaves whole quanta, so
+     the batch falls back to 64 bits. A task joining later does not
+     bring compact lanes back; a reset does.
+   */
+  TaskSystem system(1);
+  system.addTask(Task::Parameters{2, 8});
+  system.addServer(ServerTask::Kind::CBS, 2, 8,
+                   std::make_unique<PoissonArrivals>(4, 3));
+  CHECK(system.compact());
+  while (system.compact() && system.T() < 200) {
+    system(PriorityDriven::EDF(system.T(), 1, system.readyState()));
+  }
+  CHECK(!system.compact());
+
+  system.addTask(Task::Parameters{2, 16});
+  CHECK(!system.compact());
+  system.reset();
+  CHECK(system.compact());
+}
+} // namespace
+
+int main() {
+  batchStepsLikeTasks();
+  batchKeepsSlots();
+  systemStepsAlikeOnAllKernels();
+  compactBeyondTheHyperperiod();
+  staysWideAfterFallingBack();
+  return 0;
+}
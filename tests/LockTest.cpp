@@ -0,0 +1,104 @@
+#include "Check.hpp"
+#include <LockManager.hpp>
+#include <TaskSystem.hpp>
+#include <vector>
+
+namespace {
+Task job(time_t C, time_t D, int resource) {
+  Task task(Task::Parameters{C, D});
+  task.setSections({{resource, 0, 1}});
+  return task;
+}
+
+void inheritsOnlyWhenBlocking() {
+  /* Under PCP a holder runs ahead only for the higher priority jobs
+     it blocks, directly or through its ceiling.
+   */
+  LockManager locks(LockManager::Protocol::PCP);
+  auto r1 = locks.addResource(), r2 = locks.addResource();
+  auto low = job(2, 20, r1), mid = job(2, 10, r2), high = job(2, 5, r2);
+  locks.use(r1, 20);
+  locks.use(r2, 10);
+  locks.use(r2, 5);
+
+  using Outcome = LockManager::Outcome;
+  CHECK(locks.request(&low, 0) == Outcome::GRANTED);
+  CHECK(locks.request(&mid, 0) == Outcome::GRANTED);
+  CHECK(!locks.boosted(low) && !locks.boosted(mid));
+  CHECK(locks.request(&high, 0) == Outcome::SUSPEND);
+  CHECK(locks.boosted(mid));
+  CHECK(!locks.boosted(low)); // Its ceiling of 20 does not block high
+
+  locks.release(&mid, 1);
+  CHECK(locks.resources()[r2 - 1].owner() == &high);
+  CHECK(!locks.boosted(low));
+}
+
+void inheritsThroughTheCeiling() {
+  /* A job held back by the ceiling of a resource it does not use
+     boosts the holder of that resource.
+   */
+  LockManager locks(LockManager::Protocol::PCP);
+  auto r1 = locks.addResource(), r2 = locks.addResource();
+  auto low = job(2, 20, r1), high = job(2, 5, r2);
+  locks.use(r1, 20);
+  locks.use(r1, 5);
+  locks.use(r2, 5);
+
+  CHECK(locks.request(&low, 0) == LockManager::Outcome::GRANTED);
+  CHECK(locks.request(&high, 0) == LockManager::Outcome::SUSPEND);
+  CHECK(locks.boosted(low));
+  locks.release(&low, 1);
+  CHECK(locks.resources()[r2 - 1].owner() == &high);
+}
+
+void stopsAtSectionBoundaries() {
+  /* Two jobs at speed 2 reach their section start halfway through a
+     step. They stop there, so only one enters the section at a time,
+     and the holder stops at the section end to release it.
+   */
+  TaskSystem system(std::vector<double>{2.0, 2.0});
+  system.setProtocol(LockManager::Protocol::FMLP_PLUS);
+  auto r = system.addResource();
+  int ids[] = {system.addTask(Task::Parameters{4, 10}, {{r, 1, 2}}),
+               system.addTask(Task::Parameters{4, 10}, {{r, 1, 2}})};
+  const auto &resource = system.locks().resources()[r - 1];
+
+  auto inside = [&system, ids](int k) {
+    auto executed = system.task(ids[k])->executed();
+    return executed > 1 && executed < 3;
+  };
+  auto step = [&system]() {
+    std::vector<int> indices;
+    for (int i = 0; i < system.readyState().size(); i++) {
+      indices.emplace_back(i);
+    }
+    system(indices);
+  };
+
+  step();
+  CHECK(system.task(ids[0])->executed() == 1);
+  CHECK(system.task(ids[1])->executed() == 1);
+  CHECK(resource.stats().acquisitions == 0);
+
+  while (system.completedState().size() < 2) {
+    step();
+    // Inside its section a job holds the resource, and they take turns
+    for (int k = 0; k < 2; k++) {
+      CHECK(!inside(k) || system.task(ids[k])->held() == r);
+    }
+    CHECK(!(inside(0) && inside(1)));
+  }
+  CHECK(resource.stats().acquisitions == 2);
+  CHECK(resource.stats().contended == 1);
+  CHECK(!resource.locked());
+  CHECK(system.T() == 4);
+}
+} // namespace
+
+int main() {
+  inheritsOnlyWhenBlocking();
+  inheritsThroughTheCeiling();
+  stopsAtSectionBoundaries();
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/MixedCriticality.hpp>
+#include <vector>
+
+namespace {
+Task::Parameters hi(time_t C, time_t CH, time_t T) {
+  Task::Parameters params(C, T);
+  params.L = 1;
+  params.CH = CH;
+  params.A = CH; // Every job overruns its LO budget
+  return params;
+}
+
+void completesEarly() {
+  /* A job needing less than its WCET completes once it has run A.
+   */
+  TaskSystem system(1);
+  Task::Parameters params(5, 10);
+  params.A = 3;
+  auto id = system.addTask(params);
+  system({0});
+  system({0});
+  CHECK(system.task(id)->attrs().Ct == 3);
+  system({0});
+  CHECK(system.task(id)->attrs().Ct == 0);
+  CHECK(system.readyState().empty());
+  CHECK(system.completedState().size() == 1);
+}
+
+void overrunsWithinAStep() {
+  /* At speed 2 a job passes its LO budget halfway through a step, and
+     the rest of that step goes to the overrun.
+   */
+  TaskSystem system(std::vector<double>{2.0});
+  auto id = system.addTask(hi(3, 6, 10));
+  system({0});
+  system({0});
+  CHECK(system.task(id)->overran());
+  CHECK(system.task(id)->executed() == 4);
+  CHECK(system.task(id)->attrs().Ct == 2);
+  system({0});
+  CHECK(system.task(id)->attrs().Ct == 0);
+  CHECK(system.completedState().size() == 1);
+}
+
+void dropsLoJobsOnOverrun() {
+  /* The HI task overruns its LO budget in every job, dropping the
+     pending LO job. Lost work leaves out the overheads charged to it.
+   */
+  TaskSystem system(1);
+  Task::Overheads overheads;
+  overheads.release = 1;
+  system.setOverheads(overheads);
+  system.addTask(hi(1, 3, 10));
+  system.addTask(Task::Parameters{4, 10});
+
+  auto state = &system.readyState();
+  while (system.T() < 20) {
+    state = &system(MixedCriticality::AMC(system.T(), 1, *state));
+  }
+  CHECK(system.modeSwitches() == 2);
+  CHECK(system.lostJobs() == 2);
+  CHECK(system.lostWork() == 8);
+}
+
+void testsResponseTimes() {
+  /* AMC-rtb counts higher LO tasks only up to the LO response time:
+     here 6 + 2 = 8 fits the deadline, while counting them up to the
+     HI response time would not. One more unit of HI budget fails.
+   */
+  TaskState states;
+  auto add = [&states](int id, const Task::Parameters &params) {
+    states.emplace_back(id, params, Task::Attributes(params));
+  };
+  add(1, Task::Parameters{2, 4});
+  add(2, hi(2, 6, 8));
+  CHECK(MixedCriticality::AMCrtb(states));
+
+  std::get<1>(states[1]) = hi(2, 7, 8);
+  CHECK(!MixedCriticality::AMCrtb(states));
+
+  // LO mode alone already overloads
+  states.clear();
+  add(1, Task::Parameters{3, 4});
+  add(2, hi(3, 3, 8));
+  CHECK(!MixedCriticality::AMCrtb(states));
+}
+
+void meetsDeadlinesWhenAdmitted() {
+  /* The set AMC-rtb admits runs without misses, every HI job overrunning.
+   */
+  TaskSystem system(1);
+  system.addTask(Task::Parameters{2, 4});
+  system.addTask(hi(2, 6, 8));
+  CHECK(MixedCriticality::AMCrtb(system.readyState()));
+  auto state = &system.readyState();
+  while (system.T() < 4 * system.H()) {
+    state = &system(MixedCriticality::AMC(system.T(), 1, *state));
+  }
+  CHECK(system.modeSwitches() > 0);
+}
+} // namespace
+
+int main() {
+  completesEarly();
+  overrunsWithinAStep();
+  dropsLoJobsOnOverrun();
+  testsResponseTimes();
+  meetsDeadlinesWhenAdmitted();
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <vector>
+
+namespace {
+int index(TaskSystem &system, int id) {
+  const auto &state = system.readyState();
+  for (int i = 0; i < state.size(); i++) {
+    if (std::get<0>(state[i]) == id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void switchesInOnce() {
+  /* A job continuing on its processor is not switched in again, even
+     when its first step only paid the switch.
+   */
+  TaskSystem system(1);
+  Task::Overheads overheads;
+  overheads.contextSwitch = 1;
+  system.setOverheads(overheads);
+  auto id = system.addTask(Task::Parameters{3, 10});
+
+  system({0});
+  CHECK(system.task(id)->attrs().Ct == 3);
+  while (!system.readyState().empty() && system.T() < 10) {
+    system({0});
+  }
+  CHECK(system.T() == 4);
+  CHECK(system.task(id)->overheads().switches == 1);
+  CHECK(system.task(id)->overheads().contextSwitch == 1);
+}
+
+void reloadsAfterPreemption() {
+  /* A resumed job pays the cache reload, more after migrating,
+     while a new job only pays the switch.
+   */
+  TaskSystem system(2);
+  Task::Overheads overheads;
+  overheads.preemption = 1;
+  overheads.migration = 2;
+  system.setOverheads(overheads);
+  auto id = system.addTask(Task::Parameters{3, 10});
+  auto other = system.addTask(Task::Parameters{3, 10});
+
+  system({index(system, id)});
+  CHECK(system.task(id)->overheads().cpmd == 0);
+  system({});
+  system({index(system, id)});
+  system({});
+  system({index(system, other), index(system, id)});
+
+  const auto &stats = system.task(id)->overheads();
+  CHECK(stats.switches == 3);
+  CHECK(stats.preemptions + stats.migrations == 2);
+  CHECK(stats.cpmd == stats.preemptions * 1 + stats.migrations * 2);
+  CHECK(system.overheadStats().at(other).cpmd == 0);
+}
+
+void chargesSchedulerAndRelease() {
+  /* The scheduler costs its base plus one per ready task when a job
+     is switched in; later jobs also pay their release.
+   */
+  TaskSystem system(1);
+  Task::Overheads overheads;
+  overheads.scheduler = 1;
+  overheads.schedulerPerTask = 1;
+  overheads.release = 1;
+  system.setOverheads(overheads);
+  auto id = system.addTask(Task::Parameters{3, 10});
+  system.addTask(Task::Parameters{3, 20});
+
+  system({index(system, id)});
+  CHECK(system.task(id)->attrs().Ct == 5); // 3 + 1 + 2 - 1
+  while (system.T() < 10) {
+    auto state = system.readyState();
+    system(state.empty() ? std::vector<int>{} : std::vector<int>{0});
+  }
+  CHECK(system.task(id)->attrs().Ct == 4);
+  CHECK(system.task(id)->overheads().release == 1);
+  CHECK(system.task(id)->overheads().total() == 4);
+}
+
+void chargesSchedulerOncePerStep() {
+  /* Switching in two jobs in one step runs the scheduler once: the
+     first job switched in pays for it.
+   */
+  TaskSystem system(2);
+  Task::Overheads overheads;
+  overheads.scheduler = 1;
+  overheads.schedulerPerTask = 1;
+  system.setOverheads(overheads);
+  auto first = system.addTask(Task::Parameters{3, 10});
+  auto second = system.addTask(Task::Parameters{3, 10});
+
+  system({index(system, first), index(system, second)});
+  CHECK(system.task(first)->attrs().Ct == 5); // 3 + 1 + 2 - 1
+  CHECK(system.task(second)->attrs().Ct == 2);
+  CHECK(system.task(second)->overheads().switches == 1);
+  time_t total = 0;
+  for (const auto &[id, stats] : system.overheadStats()) {
+    total += stats.contextSwitch;
+  }
+  CHECK(total == 3);
+}
+
+void ticksEveryQuantum() {
+  /* The tick is charged on every step a job runs.
+   */
+  TaskSystem system(1);
+  Task::Overheads overheads;
+  overheads.tick = 1;
+  system.setOverheads(overheads);
+  auto id = system.addTask(Task::Parameters{4, 8});
+
+  system({0});
+  CHECK(system.task(id)->attrs().Ct == 1);
+  system({0});
+  CHECK(system.task(id)->attrs().releases == 2);
+  CHECK(system.task(id)->overheads().tick == 2);
+  CHECK(system.task(id)->overheads().switches == 1);
+}
+} // namespace
+
+int main() {
+  switchesInOnce();
+  reloadsAfterPreemption();
+  chargesSchedulerAndRelease();
+  chargesSchedulerOncePerStep();
+  ticksEveryQuantum();
+  return 0;
+}
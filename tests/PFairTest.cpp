@@ -0,0 +1,71 @@
+#include "Check.hpp"
+#include <Kernels.hpp>
+#include <TaskSystem.hpp>
+#include <algorithms/PFair.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+void classifiesLikeLagAndSymbol() {
+  /* Every kernel sorts tasks as their lag and symbol say, including
+     tasks exactly on schedule (zero lag) and ones joined later.
+   */
+  std::mt19937 rng(2);
+  PFair::Batch batch;
+  for (int i = 0; i < 45; i++) {
+    auto T = 2 + static_cast<time_t>(rng() % 9);
+    batch.U.emplace_back(static_cast<double>(1 + rng() % T) / T);
+    batch.O.emplace_back(rng() % 4);
+    batch.W.emplace_back(rng() % 6);
+  }
+
+  for (auto level : {Kernels::Level::SCALAR, Kernels::Level::SSE42,
+                     Kernels::Level::AVX2}) {
+    if (level > Kernels::detect()) {
+      continue;
+    }
+    Kernels::setLevel(level);
+    for (time_t t = 4; t < 12; t++) {
+      PFair::Classes classes;
+      PFair::classify(t, batch, classes);
+      for (std::size_t i = 0; i < batch.U.size(); i++) {
+        auto now = t - static_cast<time_t>(batch.O[i]);
+        auto lag = (now * batch.U[i]) - batch.W[i];
+        auto symbol = PFair::Symbol(now, 0, batch.U[i]);
+        CHECK(Kernels::test(classes.urgent, i) == (lag > 0 && symbol >= 0));
+        CHECK(Kernels::test(classes.tnegru, i) ==
+              (!(lag > 0 && symbol >= 0) && lag < 0 && symbol <= 0));
+        CHECK(Kernels::test(classes.urgent, i) +
+                  Kernels::test(classes.tnegru, i) +
+                  Kernels::test(classes.contending, i) ==
+              1);
+      }
+    }
+  }
+  Kernels::setLevel(Kernels::detect());
+}
+
+void keepsLagsWithinOne() {
+  /* PF is pFair: over a hyperperiod no task's lag reaches one quantum
+     either way, so no deadline is missed.
+   */
+  TaskSystem system(2);
+  system.loadTasks("tasksets/example.txt");
+  auto state = &system.readyState();
+  while (system.T() < 2 * system.H()) {
+    state = &system(PFair::PF(system.T(), system.M(), *state));
+    for (auto states : {state, &system.completedState()}) {
+      for (const auto &[id, params, attrs] : *states) {
+        auto lag = PFair::computeLag(system.T(), params, attrs);
+        CHECK(lag > -1 && lag < 1);
+      }
+    }
+  }
+}
+} // namespace
+
+int main() {
+  classifiesLikeLagAndSymbol();
+  keepsLagsWithinOne();
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <vector>
+
+namespace {
+time_t remaining(TaskSystem &system, int id) {
+  return system.task(id)->attrs().Ct;
+}
+
+void runsOnTheFastestProcessor() {
+  /* On a uniform platform the first selected job takes the fastest
+     processor, and a slow one carries fractional work over.
+   */
+  TaskSystem system(std::vector<double>{0.5, 2.0});
+  CHECK(system.capacity() == 2.5);
+  auto fast = system.addTask(Task::Parameters{4, 4});
+  auto slow = system.addTask(Task::Parameters{1, 4});
+
+  system({0, 1});
+  CHECK(remaining(system, fast) == 2);
+  CHECK(remaining(system, slow) == 1); // Half a unit done, carried
+  system({0, 1});
+  CHECK(remaining(system, fast) == 0);
+  CHECK(remaining(system, slow) == 0);
+}
+
+void runsAtItsOwnSpeedOnUnrelatedPlatforms() {
+  /* Per-task speeds override the processors' own.
+   */
+  TaskSystem system(2);
+  auto id = system.addTask(Task::Parameters{3, 6}, {}, {1.0, 3.0});
+  system({0});
+  CHECK(remaining(system, id) == 0);
+}
+
+void ordersByPriority() {
+  /* EDF, DM and LLF pick the m smallest keys, ties by index.
+   */
+  TaskState states;
+  auto add = [&states](int id, time_t C, time_t T, time_t D, time_t Ct,
+                       time_t Dt) {
+    Task::Parameters params(C, T, D);
+    Task::Attributes attrs(params);
+    attrs.Ct = Ct;
+    attrs.Dt = Dt;
+    attrs.Lt = Dt - Ct;
+    states.emplace_back(id, params, attrs);
+  };
+  add(1, 2, 10, 10, 2, 9); // Dt 9, D 10, Lt 7
+  add(2, 4, 20, 8, 4, 6);  // Dt 6, D 8, Lt 2
+  add(3, 1, 10, 5, 1, 3);  // Dt 3, D 5, Lt 2
+  add(4, 1, 10, 10, 1, 3); // Dt 3, D 10, Lt 2
+
+  CHECK(PriorityDriven::EDF(0, 2, states) == std::vector<int>({2, 3}));
+  CHECK(PriorityDriven::DM(0, 2, states) == std::vector<int>({2, 1}));
+  CHECK(PriorityDriven::LLF(0, 3, states) == std::vector<int>({1, 2, 3}));
+  CHECK(PriorityDriven::EDF(0, 8, states).size() == states.size());
+}
+
+void meetsDeadlinesOnUniformPlatforms() {
+  /* Global EDF on speeds {2, 1} with a light load over a hyperperiod.
+   */
+  TaskSystem system(std::vector<double>{2.0, 1.0});
+  system.addTask(Task::Parameters{2, 4});
+  system.addTask(Task::Parameters{3, 6});
+  system.addTask(Task::Parameters{1, 3});
+  auto state = &system.readyState();
+  while (system.T() < 2 * system.H()) {
+    state = &system(PriorityDriven::EDF(system.T(), system.M(), *state));
+  }
+}
+} // namespace
+
+int main() {
+  runsOnTheFastestProcessor();
+  runsAtItsOwnSpeedOnUnrelatedPlatforms();
+  ordersByPriority();
+  meetsDeadlinesOnUniformPlatforms();
+  return 0;
+}
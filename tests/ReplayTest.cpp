@@ -0,0 +1,78 @@
+#include "Check.hpp"
+#include <Replay.hpp>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace {
+const long steps = 100000;
+
+int first(long t) { return 1 + ((t / 5000) % 3); } // Runs of 5000
+int second(long t) { return t % 3 == 0 ? 5 : 4; }  // 4 holds 2 of 3
+
+std::vector<std::vector<int>> scan(Replay &replay, time_t from, int columns,
+                                   time_t zoom) {
+  /* Reference window, reading every step in range.
+   */
+  std::vector<std::vector<int>> view(replay.M(), std::vector<int>(columns));
+  for (int c = 0; c < columns; c++) {
+    for (int p = 0; p < replay.M(); p++) {
+      std::map<int, time_t> shares;
+      Replay::Step step;
+      for (auto t = from + (c * zoom); t < from + ((c + 1) * zoom); t++) {
+        if (replay.read(t, step)) {
+          shares[step.ids[p]] += 1;
+        }
+      }
+      for (const auto &[id, held] : shares) {
+        if (held > shares[view[p][c]]) {
+          view[p][c] = id;
+        }
+      }
+    }
+  }
+  return view;
+}
+
+void summarizesZoomedOut() {
+  /* Fine views are exact; views whose columns span whole blocks come
+     from the summaries and still find the longest holders.
+   */
+  auto path = std::filesystem::temp_directory_path() / "ReplayTest.rec";
+  {
+    Recorder recorder(path.string(), 2);
+    for (long t = 0; t < steps; t++) {
+      recorder.write(t, 1, {first(t), second(t)});
+    }
+  }
+
+  Replay replay(path.string());
+  CHECK(replay.valid() && replay.steps() == steps);
+  CHECK(replay.begin() == 0 && replay.end() == steps);
+
+  auto fine = replay.window(12345, 50, 1);
+  for (int c = 0; c < 50; c++) {
+    CHECK(fine[0][c] == first(12345 + c));
+    CHECK(fine[1][c] == second(12345 + c));
+  }
+  CHECK(replay.window(4990, 20, 3) == scan(replay, 4990, 20, 3));
+
+  auto coarse = replay.window(0, 20, 5000);
+  for (int c = 0; c < 20; c++) {
+    CHECK(coarse[0][c] == first(c * 5000));
+    CHECK(coarse[1][c] == 4);
+  }
+  CHECK(replay.window(15000, 10, 4096) == scan(replay, 15000, 10, 4096));
+
+  // Past the end of the run the processors are idle
+  auto tail = replay.window(steps - 1000, 4, 1000);
+  CHECK(tail[0][0] == first(steps - 1000) && tail[0][1] == 0);
+
+  std::filesystem::remove(path);
+}
+} // namespace
+
+int main() {
+  summarizesZoomedOut();
+  return 0;
+}
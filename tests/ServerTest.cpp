@@ -0,0 +1,46 @@
+#include "Check.hpp"
+#include <TaskSystem.hpp>
+#include <algorithms/PriorityDriven.hpp>
+#include <memory>
+
+namespace {
+void step(TaskSystem &system) {
+  system(PriorityDriven::EDF(system.T(), 1, system.readyState()));
+}
+
+void retiresAtPeriodEnd(ServerTask::Kind kind) {
+  /* A retiring server serves out its current period, without
+     recharging, then leaves at its deadline and hands its bandwidth
+     back.
+   */
+  TaskSystem system(1);
+  system.addTask(Task::Parameters{1, 4});
+  auto id = system.addServer(kind, 2, 5,
+                             std::make_unique<PoissonArrivals>(3, 1));
+  CHECK(system.util() == 0.65);
+  while (system.T() < 7) {
+    step(system);
+  }
+  CHECK(system.server(id)->responses().count > 0);
+
+  CHECK(system.retireTask(id));
+  auto deadline = system.T() + system.server(id)->attrs().Dt;
+  while (system.task(id) != nullptr && system.T() < 20) {
+    step(system);
+  }
+  CHECK(system.task(id) == nullptr);
+  CHECK(system.T() == deadline);
+  CHECK(system.util() == 0.25);
+  CHECK(system.admitTask(Task::Parameters{3, 4}) != 0);
+  for (int i = 0; i < 8; i++) {
+    step(system);
+  }
+}
+} // namespace
+
+int main() {
+  retiresAtPeriodEnd(ServerTask::Kind::CBS);
+  retiresAtPeriodEnd(ServerTask::Kind::SPORADIC);
+  retiresAtPeriodEnd(ServerTask::Kind::DEFERRABLE);
+  return 0;
+}